@@ -0,0 +1,392 @@
+// Microbenchmarks for the core engine operations.
+//
+// Runs every benchmark on a corpus of positions recorded from seeded
+// greedy self-play games, with warmup runs and repeated timed samples on a
+// pinned core, and writes the results as JSON for tracking across commits.
+//
+// usage: qwirkle_bench [--reps N] [--warmup N] [--games N] [--cpu K]
+//                      [--filter SUBSTR] [--out FILE]
+#include "GameState.h"
+#include "MoveGen.h"
+#include "Rules.h"
+#include "SaveGame.h"
+#include "ScoreBatch.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+// Keep the optimizer from discarding a computed value
+template <class T>
+void keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+bool pinToCpu(int cpu) {
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+struct Options {
+    int reps = 15;
+    int warmup = 3;
+    int games = 16;
+    int cpu = 0;
+    std::string filter;
+    std::string out;
+};
+
+// A recorded position: the state before a move, its legal moves and their
+// line lengths for batch scoring
+struct Position {
+    GameState state;
+    MoveList moves;
+    ScoreBatch batch;
+};
+
+// Best-scoring move, ties broken by generation order
+int greedyIndex(const Board& board, const MoveList& moves) {
+    int best = -1, bestScore = -1;
+    for (int i = 0; i < static_cast<int>(moves.size()); ++i) {
+        int s = rules::scoreMove(board, moves[i]);
+        if (s > bestScore) {
+            bestScore = s;
+            best = i;
+        }
+    }
+    return best;
+}
+
+std::vector<Position> recordCorpus(int games) {
+    std::vector<Position> corpus;
+    for (int g = 0; g < games; ++g) {
+        GameState state(2, 1000 + g);
+        state.deal();
+        int passes = 0;
+        while (!state.isGameOver() && passes < state.playerCount()) {
+            Position pos{state, {}, {}};
+            movegen::generateMoves(state.board, state.hand(), pos.moves, pos.batch);
+            int best = greedyIndex(state.board, pos.moves);
+            corpus.push_back(pos);
+            passes = best < 0 ? passes + 1 : 0;
+            state.applyMove(best < 0 ? Move{} : pos.moves[best]);
+        }
+    }
+    return corpus;
+}
+
+struct Result {
+    std::string name;
+    long long opsPerSample = 0;
+    std::vector<double> nsPerOp;
+};
+
+// `body` runs one sample over the corpus and returns the number of operations
+using Body = std::function<long long()>;
+
+Result measure(const std::string& name, const Options& opt, const Body& body) {
+    Result r;
+    r.name = name;
+    for (int i = 0; i < opt.warmup; ++i) body();
+    for (int i = 0; i < opt.reps; ++i) {
+        auto t0 = std::chrono::steady_clock::now();
+        long long ops = body();
+        auto t1 = std::chrono::steady_clock::now();
+        r.opsPerSample = ops;
+        r.nsPerOp.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count() / std::max(1LL, ops));
+    }
+    return r;
+}
+
+void writeJson(std::FILE* f, const std::vector<Result>& results, const Options& opt,
+               bool pinned, size_t corpusSize) {
+    std::fprintf(f, "{\n  \"context\": {\"repetitions\": %d, \"warmup\": %d, \"games\": %d, "
+                    "\"positions\": %zu, \"cpu\": %d, \"pinned\": %s},\n",
+                 opt.reps, opt.warmup, opt.games, corpusSize, opt.cpu, pinned ? "true" : "false");
+    std::fprintf(f, "  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); ++i) {
+        std::vector<double> v = results[i].nsPerOp;
+        std::sort(v.begin(), v.end());
+        double mean = 0;
+        for (double x : v) mean += x;
+        mean /= v.size();
+        double var = 0;
+        for (double x : v) var += (x - mean) * (x - mean);
+        double stddev = v.size() > 1 ? std::sqrt(var / (v.size() - 1)) : 0.0;
+        std::fprintf(f, "    {\"name\": \"%s\", \"ops_per_sample\": %lld, \"ns_per_op\": "
+                        "{\"median\": %.2f, \"min\": %.2f, \"mean\": %.2f, \"stddev\": %.2f}}%s\n",
+                     results[i].name.c_str(), results[i].opsPerSample, v[v.size() / 2], v.front(),
+                     mean, stddev, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--reps" && hasValue) opt.reps = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--warmup" && hasValue) opt.warmup = std::atoi(argv[++i]);
+        else if (arg == "--games" && hasValue) opt.games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--cpu" && hasValue) opt.cpu = std::atoi(argv[++i]);
+        else if (arg == "--filter" && hasValue) opt.filter = argv[++i];
+        else if (arg == "--out" && hasValue) opt.out = argv[++i];
+        else {
+            std::cerr << "usage: qwirkle_bench [--reps N] [--warmup N] [--games N] [--cpu K] "
+                         "[--filter SUBSTR] [--out FILE]\n";
+            return 1;
+        }
+    }
+
+    bool pinned = pinToCpu(opt.cpu);
+    if (!pinned) std::cerr << "Warning: could not pin to cpu " << opt.cpu << "\n";
+
+    const std::vector<Position> corpus = recordCorpus(opt.games);
+
+    std::vector<std::pair<std::string, Body>> benches;
+
+    benches.push_back({"board_place_tile", [&] {
+        long long ops = 0;
+        for (const Position& p : corpus) {
+            Board b;
+            for (const auto& t : p.state.board.getTiles()) b.placeTile(t.first.first, t.first.second, t.second);
+            keep(b.getHash());
+            ops += static_cast<long long>(p.state.board.getTiles().size());
+        }
+        return ops;
+    }});
+
+    benches.push_back({"board_is_occupied", [&] {
+        long long ops = 0;
+        int hits = 0;
+        for (const Position& p : corpus) {
+            for (const auto& t : p.state.board.getTiles()) {
+                hits += p.state.board.isOccupied(t.first.first + 1, t.first.second);
+                hits += p.state.board.isOccupied(t.first.first, t.first.second - 1);
+                ops += 2;
+            }
+        }
+        keep(hits);
+        return ops;
+    }});
+
+    benches.push_back({"bag_init", [&] {
+        GameState s(1, 7);
+        for (int i = 0; i < 1000; ++i) {
+            s.initTileBag();
+            keep(s.tileBag.back());
+        }
+        return 1000LL;
+    }});
+
+    benches.push_back({"bag_draw", [&] {
+        GameState s(1, 7);
+        s.initTileBag();
+        const std::vector<Tile> full = s.tileBag;
+        long long ops = 0;
+        for (int i = 0; i < 100; ++i) {
+            s.tileBag = full;
+            while (!s.tileBag.empty()) {
+                Tile t = s.drawTileFromBag();
+                keep(t);
+                ++ops;
+            }
+        }
+        return ops;
+    }});
+
+    benches.push_back({"hand_refill", [&] {
+        GameState s(1, 7);
+        for (const Position& p : corpus) {
+            s.tileBag = p.state.tileBag;
+            for (auto& slot : s.hands[0]) slot.reset();
+            s.refillHand(0);
+            keep(s.hands[0]);
+        }
+        return static_cast<long long>(corpus.size());
+    }});
+
+    benches.push_back({"move_generation", [&] {
+        MoveList moves;
+        for (const Position& p : corpus) {
+            moves.clear();
+            movegen::generateMoves(p.state.board, p.state.hand(), moves);
+            keep(moves.size());
+        }
+        return static_cast<long long>(corpus.size());
+    }});
+
+    benches.push_back({"move_generation_batch", [&] {
+        MoveList moves;
+        ScoreBatch batch;
+        for (const Position& p : corpus) {
+            moves.clear();
+            batch.clear();
+            movegen::generateMoves(p.state.board, p.state.hand(), moves, batch);
+            keep(batch.size());
+        }
+        return static_cast<long long>(corpus.size());
+    }});
+
+    benches.push_back({"move_validation", [&] {
+        long long ops = 0;
+        int valid = 0;
+        for (const Position& p : corpus) {
+            for (const Move& m : p.moves) valid += rules::validateMove(p.state.board, m);
+            ops += static_cast<long long>(p.moves.size());
+        }
+        keep(valid);
+        return ops;
+    }});
+
+    benches.push_back({"move_scoring", [&] {
+        long long ops = 0;
+        int total = 0;
+        for (const Position& p : corpus) {
+            for (const Move& m : p.moves) total += rules::scoreMove(p.state.board, m);
+            ops += static_cast<long long>(p.moves.size());
+        }
+        keep(total);
+        return ops;
+    }});
+
+    // Per move, as move_scoring, from the line lengths movegen recorded
+    std::vector<std::uint8_t> batchScores, batchQwirkles;
+    for (const Position& p : corpus) batchScores.resize(std::max(batchScores.size(), p.moves.size()));
+    batchQwirkles.resize(batchScores.size());
+
+    benches.push_back({"move_scoring_batch", [&] {
+        long long ops = 0;
+        for (const Position& p : corpus) {
+            rules::scoreBatch(p.batch, batchScores.data(), batchQwirkles.data());
+            keep(batchScores[0]);
+            ops += static_cast<long long>(p.moves.size());
+        }
+        return ops;
+    }});
+
+    benches.push_back({"move_scoring_batch_scalar", [&] {
+        long long ops = 0;
+        for (const Position& p : corpus) {
+            rules::scoreBatchScalar(p.batch, batchScores.data(), batchQwirkles.data());
+            keep(batchScores[0]);
+            ops += static_cast<long long>(p.moves.size());
+        }
+        return ops;
+    }});
+
+    benches.push_back({"hash_full_recompute", [&] {
+        std::uint64_t h = 0;
+        for (const Position& p : corpus) {
+            for (const auto& t : p.state.board.getTiles()) h ^= zobrist::key(t.first.first, t.first.second, t.second);
+        }
+        keep(h);
+        return static_cast<long long>(corpus.size());
+    }});
+
+    benches.push_back({"state_copy", [&] {
+        for (const Position& p : corpus) {
+            GameState s = p.state;
+            keep(s.board.getHash());
+        }
+        return static_cast<long long>(corpus.size());
+    }});
+
+    benches.push_back({"board_copy_monotonic", [&] {
+        static char buffer[1 << 16];
+        for (const Position& p : corpus) {
+            std::pmr::monotonic_buffer_resource scratch(buffer, sizeof buffer);
+            Board b(p.state.board, &scratch);
+            keep(b.getHash());
+        }
+        return static_cast<long long>(corpus.size());
+    }});
+
+    std::vector<std::string> binarySaves, jsonSaves;
+    for (const Position& p : corpus) {
+        binarySaves.emplace_back();
+        savegame::writeBinary(binarySaves.back(), p.state);
+        jsonSaves.emplace_back();
+        savegame::writeJson(jsonSaves.back(), p.state);
+    }
+
+    benches.push_back({"save_binary", [&] {
+        std::string out;
+        for (const Position& p : corpus) {
+            out.clear();
+            savegame::writeBinary(out, p.state);
+            keep(out.size());
+        }
+        return static_cast<long long>(corpus.size());
+    }});
+
+    benches.push_back({"load_binary", [&] {
+        GameState s(1, 0);
+        for (const std::string& data : binarySaves) {
+            keep(savegame::readBinary(data.data(), data.size(), s));
+        }
+        return static_cast<long long>(binarySaves.size());
+    }});
+
+    benches.push_back({"save_json", [&] {
+        std::string out;
+        for (const Position& p : corpus) {
+            out.clear();
+            savegame::writeJson(out, p.state);
+            keep(out.size());
+        }
+        return static_cast<long long>(corpus.size());
+    }});
+
+    benches.push_back({"load_json", [&] {
+        GameState s(1, 0);
+        for (const std::string& data : jsonSaves) {
+            keep(savegame::readJson(data.data(), data.size(), s));
+        }
+        return static_cast<long long>(jsonSaves.size());
+    }});
+
+    std::vector<Result> results;
+    for (const auto& b : benches) {
+        if (!opt.filter.empty() && b.first.find(opt.filter) == std::string::npos) continue;
+        results.push_back(measure(b.first, opt, b.second));
+    }
+
+    std::FILE* f = opt.out.empty() ? stdout : std::fopen(opt.out.c_str(), "w");
+    if (!f) {
+        std::cerr << "Error: cannot write '" << opt.out << "'\n";
+        return 1;
+    }
+    writeJson(f, results, opt, pinned, corpus.size());
+    if (f != stdout) std::fclose(f);
+    return 0;
+}
@@ -0,0 +1,80 @@
+// Probe/store throughput of the shared transposition table under contention.
+// usage: qwirkle_tt_bench [megabytes=64] [millis-per-run=500]
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ThreadResult {
+    std::uint64_t ops = 0;
+    std::uint64_t hits = 0;
+};
+
+int main(int argc, char** argv) {
+    std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 64;
+    int millis = argc > 2 ? std::atoi(argv[2]) : 500;
+
+    TranspositionTable table(megabytes);
+    // Draw keys from a space larger than the table so both hits and
+    // replacements happen, and all threads share it so they contend.
+    const std::uint64_t keySpace = table.bucketCount() * 8;
+
+    std::printf("table: %zu MiB, %zu buckets, pages: %s\n",
+                table.sizeBytes() >> 20, table.bucketCount(), TranspositionTable::pagesName(table.pages()));
+    std::printf("%8s %14s %10s\n", "threads", "Mops/s", "hit rate");
+
+    for (int threads = 1; threads <= 64; threads *= 2) {
+        table.clear();
+        std::atomic<bool> start{false};
+        std::atomic<bool> stop{false};
+        std::vector<ThreadResult> results(threads);
+        std::vector<std::thread> workers;
+
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                ThreadResult local;
+                std::uint64_t state = zobrist::mix(static_cast<std::uint64_t>(t) + 1);
+                while (!start.load(std::memory_order_acquire)) std::this_thread::yield();
+                while (!stop.load(std::memory_order_relaxed)) {
+                    for (int i = 0; i < 256; ++i) {
+                        state = zobrist::mix(state);
+                        std::uint64_t hash = zobrist::mix(state % keySpace);
+                        TTData d;
+                        if (table.probe(hash, d)) {
+                            ++local.hits;
+                        } else {
+                            d.move = static_cast<std::uint32_t>(state);
+                            d.score = static_cast<std::int16_t>(state >> 40);
+                            d.depth = static_cast<std::uint8_t>(state >> 56) & 0x1F;
+                            d.bound = Bound::Exact;
+                            table.store(hash, d);
+                        }
+                    }
+                    local.ops += 256;
+                }
+                results[t] = local;
+            });
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        start.store(true, std::memory_order_release);
+        std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+        stop.store(true);
+        for (auto& w : workers) w.join();
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        ThreadResult total;
+        for (const auto& r : results) {
+            total.ops += r.ops;
+            total.hits += r.hits;
+        }
+        std::printf("%8d %14.2f %9.1f%%\n", threads, total.ops / secs / 1e6,
+                    total.ops ? 100.0 * total.hits / total.ops : 0.0);
+    }
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "Arena.h"
+#include <algorithm>
+
+namespace {
+char* alignUp(char* p, std::size_t align) {
+    auto v = reinterpret_cast<std::uintptr_t>(p);
+    return reinterpret_cast<char*>((v + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1));
+}
+} // namespace
+
+Arena::Arena(std::size_t capBytes, std::size_t blockSize)
+    : capBytes(capBytes), preferredBlockSize(blockSize), blockSize(std::min(blockSize, capBytes)) {}
+
+Arena::~Arena() {
+    release();
+}
+
+Arena::Arena(Arena&& other) noexcept
+    : capBytes(other.capBytes), preferredBlockSize(other.preferredBlockSize), blockSize(other.blockSize) {
+    swap(other);
+}
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+        release();
+        swap(other);
+    }
+    return *this;
+}
+
+void Arena::swap(Arena& other) noexcept {
+    std::swap(blocks, other.blocks);
+    std::swap(current, other.current);
+    std::swap(usedBefore, other.usedBefore);
+    std::swap(ptr, other.ptr);
+    std::swap(end, other.end);
+    std::swap(reserved, other.reserved);
+    std::swap(capBytes, other.capBytes);
+    std::swap(preferredBlockSize, other.preferredBlockSize);
+    std::swap(blockSize, other.blockSize);
+}
+
+void* Arena::allocate(std::size_t bytes, std::size_t align) {
+    char* p = ptr ? alignUp(ptr, align) : nullptr;
+    if (!p || p + bytes > end) {
+        if (!nextBlock(bytes, align)) return nullptr;
+        p = alignUp(ptr, align);
+    }
+    ptr = p + bytes;
+    return p;
+}
+
+bool Arena::nextBlock(std::size_t bytes, std::size_t align) {
+    // Reuse retained blocks first (after a reset), skipping any too small
+    std::size_t next = ptr ? current + 1 : 0;
+    for (; next < blocks.size(); ++next) {
+        if (blocks[next].size >= bytes + align) break;
+    }
+    if (next == blocks.size()) {
+        std::size_t size = std::max(blockSize, bytes + align);
+        if (size > capBytes || reserved > capBytes - size) return false;
+        char* data = static_cast<char*>(::operator new(size, std::nothrow));
+        if (!data) return false;
+        blocks.push_back({data, size});
+        reserved += size;
+    }
+    if (ptr) usedBefore += static_cast<std::size_t>(ptr - blocks[current].data);
+    current = next;
+    ptr = blocks[current].data;
+    end = ptr + blocks[current].size;
+    return true;
+}
+
+void Arena::reset() {
+    current = 0;
+    usedBefore = 0;
+    if (blocks.empty()) {
+        ptr = end = nullptr;
+    } else {
+        ptr = blocks[0].data;
+        end = ptr + blocks[0].size;
+    }
+}
+
+void Arena::release() {
+    for (const Block& b : blocks) ::operator delete(b.data);
+    blocks.clear();
+    reserved = 0;
+    reset();
+}
+
+std::size_t Arena::bytesUsed() const {
+    if (!ptr) return 0;
+    return usedBefore + static_cast<std::size_t>(ptr - blocks[current].data);
+}
+
+Arena& Arena::threadLocal() {
+    thread_local Arena arena;
+    return arena;
+}
@@ -0,0 +1,100 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Bump allocator for short-lived search data (child states, move lists).
+// Memory is carved sequentially from large blocks and only released in bulk:
+// reset() rewinds to the first block in O(1) and keeps every block for reuse,
+// so a search that allocates millions of nodes per move never goes back to
+// the global heap once warmed up. Destructors are never run.
+// Not thread-safe: give each search thread its own arena (see threadLocal()).
+class Arena {
+public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = std::size_t(1) << 20;
+    static constexpr std::size_t NO_CAP = SIZE_MAX;
+
+    explicit Arena(std::size_t capBytes = NO_CAP, std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+    void swap(Arena& other) noexcept;
+
+    // Returns nullptr once the cap would be exceeded
+    void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t));
+
+    template <class T, class... Args>
+    T* create(Args&&... args) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+        void* p = allocate(sizeof(T), alignof(T));
+        return p ? new (p) T(std::forward<Args>(args)...) : nullptr;
+    }
+
+    template <class T>
+    T* allocateArray(std::size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena objects are never destroyed");
+        return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    // Invalidate everything allocated so far; keeps blocks for reuse
+    void reset();
+    // Reset and return all blocks to the system
+    void release();
+
+    std::size_t bytesUsed() const;
+    std::size_t bytesReserved() const { return reserved; }
+    std::size_t cap() const { return capBytes; }
+    void setCap(std::size_t bytes) {
+        capBytes = bytes;
+        blockSize = std::min(preferredBlockSize, bytes);
+    }
+
+    // Per-thread scratch arena for code that has no search context to hand
+    static Arena& threadLocal();
+
+private:
+    struct Block {
+        char* data;
+        std::size_t size;
+    };
+
+    bool nextBlock(std::size_t bytes, std::size_t align);
+
+    std::vector<Block> blocks;
+    std::size_t current = 0;       // index of the block being bumped
+    std::size_t usedBefore = 0;    // bytes in blocks before `current`
+    char* ptr = nullptr;
+    char* end = nullptr;
+    std::size_t reserved = 0;      // total size of all blocks
+    std::size_t capBytes;
+    std::size_t preferredBlockSize; // as constructed; blockSize is it within the cap
+    std::size_t blockSize;
+};
+
+// std::pmr adapter so standard containers (Board tiles, MoveList, ...) can
+// allocate from an arena. Deallocation is a no-op; memory comes back on the
+// arena's reset(). Throws std::bad_alloc when the arena's cap is reached.
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(Arena& arena) : arena(arena) {}
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t align) override {
+        void* p = arena.allocate(bytes, align);
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    Arena& arena;
+};
@@ -1,9 +1,214 @@
 #include "Board.h"
+#include "Rules.h"
+#include "Zobrist.h"
+#include <algorithm>
 
 void Board::placeTile(int x, int y, const Tile& tile) {
-    tiles[{x, y}] = tile;
+    auto result = tiles.insert({{x, y}, tile});
+    if (!result.second) {
+        // overwriting: remove the old tile's key first
+        hash ^= zobrist::key(x, y, result.first->second);
+        result.first->second = tile;
+    }
+    hash ^= zobrist::key(x, y, tile);
+
+    frontier.erase({x, y});
+    static const int dx[4] = {1, -1, 0, 0};
+    static const int dy[4] = {0, 0, 1, -1};
+    for (int i = 0; i < 4; ++i) {
+        if (!isOccupied(x + dx[i], y + dy[i])) frontier.insert({x + dx[i], y + dy[i]});
+    }
+    insertCell(x, y).tile = tile;
+    joinSegments(x, y, tile, false, !result.second);
+    joinSegments(x, y, tile, true, !result.second);
+    if (tracksLines) updateLines(x, y);
+}
+
+void Board::trackLines() {
+    if (tracksLines) return;
+    tracksLines = true;
+    // Each line is derived once per tile on it; refreshing replaces the entry
+    for (const auto& p : tiles) {
+        refreshLine(p.first.first, p.first.second, false, false);
+        refreshLine(p.first.first, p.first.second, true, false);
+    }
+}
+
+std::size_t Board::slotOf(int x, int y) const {
+    // Fibonacci hashing of the packed coordinate; the top bits are the best mixed
+    std::uint64_t key = static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32 | static_cast<std::uint32_t>(y);
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> (64 - cellBits));
+}
+
+const Board::Cell* Board::findCell(int x, int y) const {
+    if (cells.empty()) return nullptr;
+    std::size_t mask = cells.size() - 1;
+    for (std::size_t i = slotOf(x, y);; i = (i + 1) & mask) {
+        const Cell& c = cells[i];
+        if (!c.used) return nullptr;
+        if (c.pos.first == x && c.pos.second == y) return &c;
+    }
+}
+
+Board::Cell& Board::insertCell(int x, int y) {
+    if (Cell* c = findCell(x, y)) return *c;
+    if (2 * (cellCount + 1) > static_cast<int>(cells.size())) {
+        std::pmr::vector<Cell> old(cells.get_allocator());
+        old.swap(cells);
+        cellBits = std::max(cellBits + 1, 6);
+        cells.assign(std::size_t{1} << cellBits, Cell{});
+        for (const Cell& c : old) {
+            if (!c.used) continue;
+            std::size_t i = slotOf(c.pos.first, c.pos.second);
+            while (cells[i].used) i = (i + 1) & (cells.size() - 1);
+            cells[i] = c;
+        }
+    }
+    std::size_t i = slotOf(x, y);
+    while (cells[i].used) i = (i + 1) & (cells.size() - 1);
+    ++cellCount;
+    cells[i].pos = { x, y };
+    cells[i].used = true;
+    return cells[i];
 }
 
 bool Board::isOccupied(int x, int y) const {
-    return tiles.find({x, y}) != tiles.end();
+    return findCell(x, y) != nullptr;
+}
+
+const Tile* Board::tileAt(int x, int y) const {
+    const Cell* c = findCell(x, y);
+    return c ? &c->tile : nullptr;
+}
+
+const Segment* Board::segmentAt(int x, int y, bool vertical) const {
+    const Cell* c = findCell(x, y);
+    if (!c) return nullptr;
+    return vertical ? &c->column : &c->row;
+}
+
+// Merge the runs on either side of the new tile at (x, y) into one segment
+// and store it in each of its cells. An overwritten tile keeps the extent
+// but its run's masks are rebuilt from the tiles.
+void Board::joinSegments(int x, int y, const Tile& tile, bool vertical, bool overwrite) {
+    int dx = vertical ? 0 : 1, dy = vertical ? 1 : 0;
+    Segment merged;
+    if (overwrite) {
+        merged = *segmentAt(x, y, vertical);
+        merged.colors = merged.shapes = 0;
+        for (int i = merged.start; i < merged.end(); ++i) {
+            const Tile* t = vertical ? tileAt(x, i) : tileAt(i, y);
+            merged.colors |= 1u << static_cast<int>(t->color);
+            merged.shapes |= 1u << static_cast<int>(t->shape);
+        }
+    } else {
+        const Segment* before = segmentAt(x - dx, y - dy, vertical);
+        const Segment* after = segmentAt(x + dx, y + dy, vertical);
+        merged.start = before ? before->start : (vertical ? y : x);
+        merged.length = static_cast<std::uint8_t>(1 + (before ? before->length : 0) + (after ? after->length : 0));
+        merged.colors = static_cast<std::uint8_t>(1u << static_cast<int>(tile.color));
+        merged.shapes = static_cast<std::uint8_t>(1u << static_cast<int>(tile.shape));
+        for (const Segment* side : { before, after }) {
+            if (!side) continue;
+            merged.colors |= side->colors;
+            merged.shapes |= side->shapes;
+        }
+    }
+    auto single = [](unsigned m) { return m && !(m & (m - 1)); };
+    merged.uniform = (single(merged.colors) ? Segment::SAME_COLOR : 0) | (single(merged.shapes) ? Segment::SAME_SHAPE : 0);
+
+    for (int i = merged.start; i < merged.end(); ++i) {
+        Cell* c = vertical ? findCell(x, i) : findCell(i, y);
+        (vertical ? c->column : c->row) = merged;
+    }
+}
+
+void Board::addLine(const OpenLine& line) {
+    openLines.emplace(LineKey{ line.start, line.vertical }, line);
+    ++openCounts[line.length - 4];
+    if (line.length != 5) return;
+    for (int k = 0; k < TILE_KINDS; ++k) {
+        if ((line.completers >> k & 1) && qwirkleKinds[k]++ == 0) qwirkleMask |= std::uint64_t{1} << k;
+    }
+}
+
+void Board::removeLine(OpenLineMap::iterator it) {
+    const OpenLine& line = it->second;
+    --openCounts[line.length - 4];
+    if (line.length == 5) {
+        for (int k = 0; k < TILE_KINDS; ++k) {
+            if ((line.completers >> k & 1) && --qwirkleKinds[k] == 0) qwirkleMask &= ~(std::uint64_t{1} << k);
+        }
+    }
+    openLines.erase(it);
+}
+
+// Re-derive the line through (x, y), if occupied. With `eraseInside`,
+// entries for shorter runs that started inside it (merged by a new tile) are
+// dropped too.
+void Board::refreshLine(int x, int y, bool vertical, bool eraseInside) {
+    const Segment* seg = segmentAt(x, y, vertical);
+    if (!seg || seg->length < 4) return; // neither it nor any run it absorbed was tracked
+    int dx = vertical ? 0 : 1, dy = vertical ? 1 : 0;
+    (vertical ? y : x) = seg->start;
+    rules::LineMasks line;
+    rules::addToLine(line, *seg);
+
+    for (int i = 0; i < (eraseInside ? line.length : 1); ++i) {
+        auto it = openLines.find(LineKey{ { x + i * dx, y + i * dy }, vertical });
+        if (it != openLines.end()) removeLine(it);
+    }
+    if (line.length != 4 && line.length != 5) return;
+
+    // Kinds that keep the shared attribute and differ in the other one
+    std::uint64_t candidates = 0;
+    auto single = [](unsigned m) { return m && !(m & (m - 1)); };
+    for (int a = 0; a < 6; ++a) {
+        for (int b = 0; b < 6; ++b) {
+            bool fits = single(line.colors) ? (line.colors >> a & 1) && !(line.shapes >> b & 1)
+                      : single(line.shapes) ? (line.shapes >> b & 1) && !(line.colors >> a & 1)
+                      : false;
+            if (fits) candidates |= std::uint64_t{1} << (a * 6 + b); // color-major, as tileIndex
+        }
+    }
+
+    std::uint64_t completers = 0;
+    for (int side = 0; side < 2 && candidates; ++side) {
+        int step = side == 0 ? -1 : 1;
+        int ex = side == 0 ? x - dx : x + line.length * dx;
+        int ey = side == 0 ? y - dy : y + line.length * dy;
+        // Tiles just beyond the end join the line; tiles across it form the cross line
+        rules::LineMasks beyond = line, cross;
+        if (const Segment* s = segmentAt(ex + step * dx, ey + step * dy, vertical)) rules::addToLine(beyond, *s);
+        if (const Segment* s = segmentAt(ex - dy, ey - dx, !vertical)) rules::addToLine(cross, *s);
+        if (const Segment* s = segmentAt(ex + dy, ey + dx, !vertical)) rules::addToLine(cross, *s);
+        for (int k = 0; k < TILE_KINDS; ++k) {
+            if (!(candidates >> k & 1) || (completers >> k & 1)) continue;
+            rules::LineMasks main = beyond, across = cross;
+            rules::addToLine(main, tileFromIndex(k));
+            rules::addToLine(across, tileFromIndex(k));
+            if (rules::isValidLine(main) && rules::isValidLine(across)) completers |= std::uint64_t{1} << k;
+        }
+    }
+    if (completers) addLine(OpenLine{ { x, y }, vertical, static_cast<std::uint8_t>(line.length), completers });
+}
+
+// A line's open ends depend on its tiles, the cross lines at its end cells
+// and the tiles beyond them. A new tile can only change those for the lines
+// through it and the lines touching an end cell of its own row or column run.
+void Board::updateLines(int x, int y) {
+    refreshLine(x, y, false, true);
+    refreshLine(x, y, true, true);
+    const Segment& row = *segmentAt(x, y, false);
+    const Segment& column = *segmentAt(x, y, true);
+    const Coord ends[4] = { { row.end(), y }, { row.start - 1, y }, { x, column.end() }, { x, column.start - 1 } };
+    static const int dx[4] = {1, -1, 0, 0};
+    static const int dy[4] = {0, 0, 1, -1};
+    for (int d = 0; d < 4; ++d) {
+        for (int n = 0; n < 4; ++n) {
+            bool vertical = dx[n] == 0;
+            bool ownRun = (vertical == (dx[d] == 0)) && n == (d ^ 1); // back toward the new tile
+            if (!ownRun) refreshLine(ends[d].first + dx[n], ends[d].second + dy[n], vertical, false);
+        }
+    }
 }
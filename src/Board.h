@@ -1,16 +1,126 @@
 #pragma once
 #include "Tile.h"
+#include <array>
+#include <cstdint>
 #include <map>
+#include <memory_resource>
+#include <set>
 #include <utility>
+#include <vector>
 
 using Coord = std::pair<int, int>;
+using TileMap = std::pmr::map<Coord, Tile>;
+using CoordSet = std::pmr::set<Coord>;
 
+// Maximal run of tiles along a row or column, as seen from each of its cells.
+// `start` is the run's first x (row) or y (column); colors and shapes have a
+// bit per Color / Shape, so a run's legality is a couple of popcounts.
+struct Segment {
+    static constexpr std::uint8_t SAME_COLOR = 1, SAME_SHAPE = 2;
+
+    int start = 0;
+    std::uint8_t length = 0;
+    std::uint8_t colors = 0;
+    std::uint8_t shapes = 0;
+    std::uint8_t uniform = 0; // SAME_COLOR | SAME_SHAPE
+
+    int end() const { return start + length; } // one past the last tile
+};
+
+// A line of 4 or 5 tiles that some tile can still extend: a Qwirkle threat
+// at length 5, an exposed line at 4. `completers` has a bit per tile kind
+// (tileIndex) that is legal at either open end, counting the cross line
+// there and any tiles just beyond it.
+struct OpenLine {
+    Coord start; // leftmost / topmost tile
+    bool vertical;
+    std::uint8_t length;
+    std::uint64_t completers;
+};
+using LineKey = std::pair<Coord, bool>; // start, vertical
+using OpenLineMap = std::pmr::map<LineKey, OpenLine>;
+
+// The board allocates through a std::pmr memory resource (the global heap by
+// default). Simulation code that churns through many short-lived boards can
+// hand in a monotonic buffer or an ArenaResource instead, e.g.
+//     std::pmr::monotonic_buffer_resource scratch(buffer, sizeof buffer);
+//     Board sim(board, &scratch);
 class Board {
 public:
+    explicit Board(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : tiles(resource), frontier(resource), cells(resource), openLines(resource) {}
+    Board(const Board& other, std::pmr::memory_resource* resource)
+        : tiles(other.tiles, resource), frontier(other.frontier, resource), hash(other.hash),
+          cells(other.cells, resource), cellCount(other.cellCount), cellBits(other.cellBits),
+          tracksLines(other.tracksLines), openLines(other.openLines, resource), openCounts{ other.openCounts[0], other.openCounts[1] },
+          qwirkleKinds(other.qwirkleKinds), qwirkleMask(other.qwirkleMask) {}
+    Board(const Board&) = default;
+    Board& operator=(const Board&) = default;
+    Board(Board&&) = default;
+    Board& operator=(Board&&) = default;
+
     void placeTile(int x, int y, const Tile& tile);
-    const std::map<Coord, Tile>& getTiles() const { return tiles; }
+    const TileMap& getTiles() const { return tiles; }
     bool isOccupied(int x, int y) const;
+    const Tile* tileAt(int x, int y) const; // nullptr when empty
+    bool empty() const { return tiles.empty(); }
+
+    // Empty cells orthogonally adjacent to a tile, maintained incrementally
+    const CoordSet& getFrontier() const { return frontier; }
+
+    // Zobrist hash of all placed tiles, maintained incrementally
+    std::uint64_t getHash() const { return hash; }
+
+    // Row or column run through an occupied cell, nullptr when empty. Kept
+    // per cell and merged on placement, so a lookup never walks the line.
+    const Segment* segmentAt(int x, int y, bool vertical) const;
+
+    // Open lines of length 4 and 5, maintained incrementally: each placement
+    // only revisits the lines through the new tile and those ending next to
+    // the runs it joins. Off by default, since it costs every placement
+    // several times over; trackLines() derives them for the tiles already
+    // placed and keeps them from then on. Copies inherit the setting.
+    void trackLines();
+    bool tracksOpenLines() const { return tracksLines; }
+    const OpenLineMap& getOpenLines() const { return openLines; }
+    int openLineCount(int length) const { return length == 4 || length == 5 ? openCounts[length - 4] : 0; }
+    // Bit per tile kind that completes a Qwirkle somewhere on the board
+    std::uint64_t getQwirkleCompleters() const { return qwirkleMask; }
+
+    std::pmr::memory_resource* getResource() const { return tiles.get_allocator().resource(); }
 
 private:
-    std::map<Coord, Tile> tiles; // sparse storage
+    // Occupied cell in the lookup table
+    struct Cell {
+        Coord pos;
+        Tile tile;
+        bool used = false;
+        Segment row;
+        Segment column;
+    };
+
+    const Cell* findCell(int x, int y) const;
+    Cell* findCell(int x, int y) { return const_cast<Cell*>(static_cast<const Board&>(*this).findCell(x, y)); }
+    Cell& insertCell(int x, int y);
+    std::size_t slotOf(int x, int y) const;
+    void joinSegments(int x, int y, const Tile& tile, bool vertical, bool overwrite);
+    void updateLines(int x, int y);
+    void refreshLine(int x, int y, bool vertical, bool eraseInside);
+    void addLine(const OpenLine& line);
+    void removeLine(OpenLineMap::iterator it);
+
+    TileMap tiles; // sparse storage
+    CoordSet frontier;
+    std::uint64_t hash = 0;
+    // Open addressing over a power-of-two array, at most half full. Cells are
+    // never removed, so probing needs no tombstones, and copying a board
+    // copies one flat array. `tiles` keeps the ordered view for iteration.
+    std::pmr::vector<Cell> cells;
+    int cellCount = 0;
+    int cellBits = 0; // log2 of cells.size()
+    bool tracksLines = false;
+    OpenLineMap openLines;
+    int openCounts[2] = {}; // lines of length 4, 5
+    std::array<std::uint8_t, TILE_KINDS> qwirkleKinds{}; // 5-lines each kind completes
+    std::uint64_t qwirkleMask = 0;
 };
@@ -0,0 +1,63 @@
+#include "BoardRenderer.h"
+#include <algorithm>
+
+namespace {
+
+const float MIN_SPAN = 7.0f; // tiles across an almost empty board
+
+} // namespace
+
+bool BoardRenderer::create(unsigned width, unsigned height) {
+    if (!target.create(width, height)) return false;
+    target.setSmooth(true);
+    return true;
+}
+
+void BoardRenderer::clear() {
+    quads.clear();
+    minX = maxX = minY = maxY = 0;
+}
+
+void BoardRenderer::addTile(int x, int y, const Tile& tile) {
+    if (quads.empty()) {
+        minX = maxX = x;
+        minY = maxY = y;
+    } else {
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+    quads.resize(quads.size() + 4);
+    atlas.writeQuad(&quads[quads.size() - 4], x, y, tile);
+}
+
+void BoardRenderer::animateTile(int index, float scale, sf::Uint8 alpha) {
+    sf::Vertex* quad = &quads[static_cast<size_t>(index) * 4];
+    sf::Vector2f centre((quad[0].position.x + quad[2].position.x) / 2, (quad[0].position.y + quad[2].position.y) / 2);
+    float half = scale / 2;
+    quad[0].position = sf::Vector2f(centre.x - half, centre.y - half);
+    quad[1].position = sf::Vector2f(centre.x + half, centre.y - half);
+    quad[2].position = sf::Vector2f(centre.x + half, centre.y + half);
+    quad[3].position = sf::Vector2f(centre.x - half, centre.y + half);
+    for (int i = 0; i < 4; ++i) quad[i].color = sf::Color(255, 255, 255, alpha);
+}
+
+sf::FloatRect BoardRenderer::fitArea() const {
+    // One-tile margin all round, square tiles in the image
+    sf::Vector2u size = target.getSize();
+    float aspect = static_cast<float>(size.x) / static_cast<float>(std::max(1u, size.y));
+    float w = std::max(MIN_SPAN, static_cast<float>(maxX - minX + 3));
+    float h = std::max(MIN_SPAN, static_cast<float>(maxY - minY + 3));
+    if (w / h < aspect) w = h * aspect;
+    else h = w / aspect;
+    return sf::FloatRect((minX + maxX + 1 - w) / 2, (minY + maxY + 1 - h) / 2, w, h);
+}
+
+sf::Image BoardRenderer::render(const sf::FloatRect& area) {
+    target.setView(sf::View(area));
+    target.clear(sf::Color(232, 232, 224));
+    if (!quads.empty()) target.draw(quads.data(), quads.size(), sf::Quads, sf::RenderStates(&atlas.texture()));
+    target.display();
+    return target.getTexture().copyToImage();
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include "TextureAtlas.h"
+#include "Tile.h"
+#include <SFML/Graphics.hpp>
+#include <vector>
+
+// Offscreen board images: tiles are added as they are played and the board
+// is drawn into an sf::RenderTexture, zoomed to fit, in one draw call from
+// the atlas. Needs a GL context (under xvfb-run on a headless machine) and
+// must stay on the thread that created it.
+class BoardRenderer {
+public:
+    explicit BoardRenderer(const TextureAtlas& atlas) : atlas(atlas) {}
+
+    bool create(unsigned width, unsigned height);
+
+    // Empty board
+    void clear();
+    void addTile(int x, int y, const Tile& tile);
+    int tileCount() const { return static_cast<int>(quads.size() / 4); }
+
+    // Shrinks tile `index` (in the order added) about its centre and fades
+    // it, for placement animations; scale 1 and alpha 255 restore it
+    void animateTile(int index, float scale, sf::Uint8 alpha);
+
+    // Board area, in tiles, that frames every tile with a margin
+    sf::FloatRect fitArea() const;
+
+    // Draws the board and reads the pixels back
+    sf::Image render() { return render(fitArea()); }
+    // Same, showing `area` (stretched to the image's aspect ratio)
+    sf::Image render(const sf::FloatRect& area);
+
+private:
+    const TextureAtlas& atlas;
+    sf::RenderTexture target;
+    std::vector<sf::Vertex> quads;
+    int minX = 0, maxX = 0, minY = 0, maxY = 0; // tile bounds
+};
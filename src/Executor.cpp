@@ -0,0 +1,43 @@
+#include "Executor.h"
+#include <algorithm>
+
+Executor::Executor(int threads) {
+    if (threads <= 0) threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int i = 0; i < threads; ++i) workers.push_back(std::make_unique<Worker>());
+    for (auto& w : workers) w->thread = std::thread(run, std::ref(*w));
+}
+
+void Executor::post(std::size_t key, std::coroutine_handle<> handle) {
+    Worker& w = *workers[key % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.ready.push_back(handle);
+    }
+    w.wake.notify_one();
+}
+
+void Executor::stop() {
+    for (auto& w : workers) {
+        {
+            std::lock_guard<std::mutex> lock(w->mutex);
+            w->stopping = true;
+        }
+        w->wake.notify_one();
+    }
+    for (auto& w : workers) {
+        if (w->thread.joinable()) w->thread.join();
+    }
+}
+
+void Executor::run(Worker& w) {
+    std::unique_lock<std::mutex> lock(w.mutex);
+    for (;;) {
+        w.wake.wait(lock, [&] { return w.stopping || !w.ready.empty(); });
+        if (w.ready.empty()) return; // stopping with nothing left
+        std::coroutine_handle<> next = w.ready.front();
+        w.ready.pop_front();
+        lock.unlock();
+        next.resume();
+        lock.lock();
+    }
+}
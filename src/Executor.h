@@ -0,0 +1,43 @@
+#pragma once
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small fixed pool of worker threads that resume coroutines. Each worker
+// has its own queue and a key always maps to the same worker, so the turns
+// of one game never run concurrently and need no locking of their own.
+// Requires C++20.
+class Executor {
+public:
+    explicit Executor(int threads = 0); // 0 = hardware concurrency
+    ~Executor() { stop(); }
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // Queue `handle` to be resumed on the worker for `key`; callable from
+    // any thread, including from inside a coroutine running on a worker
+    void post(std::size_t key, std::coroutine_handle<> handle);
+
+    // Lets the workers finish what is queued, then joins them
+    void stop();
+
+    int size() const { return static_cast<int>(workers.size()); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::deque<std::coroutine_handle<>> ready;
+        bool stopping = false;
+        std::thread thread;
+    };
+
+    static void run(Worker& w);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+};
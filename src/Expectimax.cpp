@@ -0,0 +1,251 @@
+#include "Expectimax.h"
+#include "MoveGen.h"
+#include "Rules.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <numeric>
+
+namespace expectimax {
+
+namespace {
+
+double binomial(int n, int k) {
+    if (k < 0 || k > n) return 0;
+    double r = 1;
+    for (int i = 1; i <= k; ++i) r = r * (n - k + i) / i;
+    return r;
+}
+
+} // namespace
+
+bool enumerateDraws(const KindCounts& pool, int count, std::vector<Draw>& out, const std::function<bool()>& stop) {
+    int suffix[TILE_KINDS + 1] = {}; // tiles in kinds k.. onward
+    for (int k = TILE_KINDS - 1; k >= 0; --k) suffix[k] = suffix[k + 1] + pool[k];
+    count = std::min(count, suffix[0]);
+    double total = binomial(suffix[0], count);
+
+    KindCounts drawn{};
+    bool halted = false;
+    auto recurse = [&](auto& self, int k, int left, double ways) -> void {
+        if (left == 0) {
+            out.push_back({ drawn, ways / total });
+            halted = out.size() % DRAW_POLL_INTERVAL == 0 && stop && stop();
+            return;
+        }
+        if (suffix[k] < left) return;
+        for (int c = std::min<int>(pool[k], left); c >= 0 && !halted; --c) {
+            drawn[k] = static_cast<std::uint8_t>(c);
+            self(self, k + 1, left - c, ways * binomial(pool[k], c));
+        }
+        drawn[k] = 0;
+    };
+    recurse(recurse, 0, count, 1.0);
+    return !halted;
+}
+
+void enumerateDraws(const KindCounts& pool, int count, std::vector<Draw>& out) {
+    enumerateDraws(pool, count, out, nullptr);
+}
+
+KindCounts unseenTiles(const GameState& state) {
+    KindCounts pool;
+    pool.fill(TILES_PER_KIND);
+    for (const auto& entry : state.board.getTiles()) --pool[tileIndex(entry.second)];
+    for (const auto& slot : state.hand()) {
+        if (slot) --pool[tileIndex(*slot)];
+    }
+    return pool;
+}
+
+} // namespace expectimax
+
+using expectimax::KindCounts;
+
+namespace {
+
+KindCounts handCounts(const Hand& hand) {
+    KindCounts counts{};
+    for (const auto& slot : hand) {
+        if (slot) ++counts[tileIndex(*slot)];
+    }
+    return counts;
+}
+
+Hand toHand(const KindCounts& counts) {
+    Hand hand;
+    for (int k = 0; k < TILE_KINDS; ++k) {
+        for (int c = 0; c < counts[k]; ++c) hand.push_back(tileFromIndex(k));
+    }
+    hand.resize(HAND_SIZE);
+    return hand;
+}
+
+} // namespace
+
+std::size_t ExpectimaxBot::ChanceKeyHash::operator()(const ChanceKey& k) const {
+    std::uint64_t h = k.draws;
+    for (int i = 0; i < TILE_KINDS; ++i) h = zobrist::mix(h ^ (static_cast<std::uint64_t>(k.pool[i]) << 8 | k.kept[i]) ^ i << 16);
+    return static_cast<std::size_t>(h);
+}
+
+double ExpectimaxBot::handValue(const KindCounts& hand) const {
+    double synergy = 0, duplicates = 0;
+    for (int a = 0; a < TILE_KINDS; ++a) {
+        if (!hand[a]) continue;
+        duplicates += hand[a] - 1;
+        for (int b = a + 1; b < TILE_KINDS; ++b) {
+            if (hand[b] && (a / 6 == b / 6 || a % 6 == b % 6)) synergy += 1;
+        }
+    }
+    return weights[TermLeaveSynergy] * synergy + weights[TermLeaveDuplicates] * duplicates;
+}
+
+bool ExpectimaxBot::shouldStop(bool readClock) {
+    if (!searching) return false;
+    if (stopFlag.load(std::memory_order_relaxed)) return true;
+    if (!hasDeadline) return false;
+    if (!readClock && ++pollCount % CLOCK_CHECK_INTERVAL != 0) return false;
+    if (Clock::now() < deadline) return false;
+    stopFlag.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+double ExpectimaxBot::chanceValue(const KindCounts& pool, const KindCounts& kept, int draws) {
+    ChanceKey key{ pool, kept, static_cast<std::uint8_t>(draws) };
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        ++hits;
+        return it->second;
+    }
+    ++nodes;
+    std::vector<expectimax::Draw>& draws0 = drawStack[0];
+    draws0.clear();
+    if (!expectimax::enumerateDraws(pool, draws, draws0, stopCheck)) return 0;
+    outcomes += draws0.size();
+
+    double value = 0;
+    for (const expectimax::Draw& d : draws0) {
+        if (shouldStop()) return 0; // a partial sum is not cached
+        KindCounts hand = kept;
+        for (int k = 0; k < TILE_KINDS; ++k) hand[k] += d.tiles[k];
+        value += d.probability * handValue(hand);
+    }
+    cache.emplace(key, value);
+    return value;
+}
+
+double ExpectimaxBot::moveValue(const Board& board, const Hand& hand, const Move& move,
+                                const KindCounts& pool, int bagSize, int depth) {
+    std::array<double, TERM_COUNT> t = heuristic.terms(board, hand, move);
+    double value = 0;
+    for (int i = 0; i < TERM_COUNT; ++i) {
+        if (i != TermLeaveSynergy && i != TermLeaveDuplicates) value += weights[i] * t[i];
+    }
+
+    KindCounts kept = handCounts(hand);
+    for (const Placement& p : move) --kept[tileIndex(p.tile)];
+    int draws = std::min(move.size(), bagSize);
+    if (bagSize == 0 && std::accumulate(kept.begin(), kept.end(), 0) == 0) {
+        return value + rules::GOING_OUT_BONUS; // went out: the game ends here
+    }
+    if (depth <= 1) return value + chanceValue(pool, kept, draws);
+
+    Board next(board);
+    for (const Placement& p : move) next.placeTile(p.pos.first, p.pos.second, p.tile);
+    ++nodes;
+    std::vector<expectimax::Draw>& draws1 = drawStack[1]; // depth 1 below only uses drawStack[0]
+    draws1.clear();
+    if (!expectimax::enumerateDraws(pool, draws, draws1, stopCheck)) return 0;
+    outcomes += draws1.size();
+    double expected = 0;
+    for (const expectimax::Draw& d : draws1) {
+        if (shouldStop(true)) return 0; // each outcome generates moves
+        KindCounts nextHand = kept, nextPool = pool;
+        for (int k = 0; k < TILE_KINDS; ++k) {
+            nextHand[k] += d.tiles[k];
+            nextPool[k] -= d.tiles[k];
+        }
+        expected += d.probability * bestValue(next, nextHand, nextPool, bagSize - draws, depth - 1);
+    }
+    return value + expected;
+}
+
+double ExpectimaxBot::bestValue(const Board& board, const KindCounts& hand,
+                                const KindCounts& pool, int bagSize, int depth) {
+    Hand slots = toHand(hand);
+    MoveList& moves = moveStack[depth - 1];
+    moves.clear();
+    if (!movegen::generateMoves(board, slots, moves, stopCheck)) return 0;
+    if (moves.empty()) return handValue(hand);
+    double best = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (shouldStop()) return 0;
+        double value = moveValue(board, slots, moves[i], pool, bagSize, depth);
+        if (i == 0 || value > best) best = value;
+    }
+    return best;
+}
+
+Move ExpectimaxBot::choose(const GameState& state, const ExpectimaxLimits& limits) {
+    stopFlag.store(false, std::memory_order_relaxed);
+    hasDeadline = limits.budgetMs > 0;
+    deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(limits.budgetMs));
+    pollCount = 0;
+    searching = true;
+    stopped = false;
+    if (cache.size() > CACHE_LIMIT) cache.clear();
+    KindCounts pool = expectimax::unseenTiles(state);
+    int bagSize = static_cast<int>(state.tileBag.size());
+    MoveList& moves = moveStack[1]; // bestValue() below the root uses moveStack[0]
+    moves.clear();
+    // Root generation polls only once it has a move, so a pass is never
+    // chosen just for lack of time
+    std::function<bool()> rootStop = [&] { return !moves.empty() && shouldStop(true); };
+    movegen::generateMoves(state.board, state.hand(), moves, rootStop);
+    if (moves.empty()) {
+        searching = false;
+        return Move{};
+    }
+
+    // Stopped while valuing a move: its value is partial, so it is left out
+    // unless it is the only one
+    std::vector<std::pair<double, size_t>> ranked; // (depth-1 value, index)
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (i > 0 && shouldStop()) break;
+        double value = moveValue(state.board, state.hand(), moves[i], pool, bagSize, 1);
+        if (i > 0 && stopFlag.load(std::memory_order_relaxed)) break;
+        ranked.push_back({ value, i });
+    }
+    // Best first; ties keep generation order so play is deterministic
+    std::stable_sort(ranked.begin(), ranked.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    size_t chosen = ranked[0].second;
+
+    size_t keep = std::min(ranked.size(), static_cast<size_t>(std::max(1, limits.width)));
+    bool deep = limits.depth >= 2 && !stopFlag.load(std::memory_order_relaxed);
+    for (size_t r = 0; r < keep && deep; ++r) {
+        const Move& m = moves[ranked[r].second];
+        std::vector<expectimax::Draw>& outcomes = drawStack[1];
+        outcomes.clear();
+        deep = expectimax::enumerateDraws(pool, std::min(m.size(), bagSize), outcomes, stopCheck)
+               && static_cast<int>(outcomes.size()) <= limits.maxOutcomes;
+    }
+    if (deep) {
+        ++deepCount;
+        double best = 0;
+        size_t deepChoice = chosen;
+        for (size_t r = 0; r < keep && !shouldStop(true); ++r) {
+            double value = moveValue(state.board, state.hand(), moves[ranked[r].second], pool, bagSize, 2);
+            if (stopFlag.load(std::memory_order_relaxed)) break;
+            if (r == 0 || value > best) {
+                best = value;
+                deepChoice = ranked[r].second;
+            }
+        }
+        // Depth-2 values of some candidates can't be compared with depth-1
+        // values of the rest, so a cut-short pass keeps the depth-1 choice
+        if (!stopFlag.load(std::memory_order_relaxed)) chosen = deepChoice;
+    }
+    stopped = stopFlag.load(std::memory_order_relaxed);
+    searching = false;
+    return moves[chosen];
+}
@@ -0,0 +1,128 @@
+#pragma once
+#include "GameState.h"
+#include "HeuristicBot.h"
+#include "Move.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace expectimax {
+
+// Tiles per kind, indexed by tileIndex
+using KindCounts = std::array<std::uint8_t, TILE_KINDS>;
+
+// One distinct refill: how many of each kind were drawn, and its probability
+struct Draw {
+    KindCounts tiles;
+    double probability;
+};
+
+// Every distinct multiset of `count` tiles drawn without replacement from
+// `pool`, with its exact multivariate hypergeometric probability. Orderings
+// of the same tiles are one outcome. Appends to `out`.
+void enumerateDraws(const KindCounts& pool, int count, std::vector<Draw>& out);
+// As above, polling `stop` every DRAW_POLL_INTERVAL outcomes; a draw of five
+// or six tiles has up to millions of them. Returns false, with `out` cut
+// short, once `stop` returns true.
+constexpr std::size_t DRAW_POLL_INTERVAL = 1024;
+bool enumerateDraws(const KindCounts& pool, int count, std::vector<Draw>& out, const std::function<bool()>& stop);
+
+// Tiles the current player cannot see: the full set minus the board and
+// their own hand. Opponent hands are part of it, as they are to the player.
+KindCounts unseenTiles(const GameState& state);
+
+} // namespace expectimax
+
+struct ExpectimaxLimits {
+    int depth = 1; // own turns looked ahead through a refill (1 or 2)
+    int width = 6; // root moves re-searched at depth 2, best depth-1 value first
+    // Depth 2 runs only when every re-searched move's refill has at most this
+    // many distinct outcomes, so all candidates are valued at the same depth
+    int maxOutcomes = 256;
+    double budgetMs = 0; // wall-clock budget, 0 = none
+};
+
+// Bot that values each move by its heuristic terms plus the expected value
+// of the hand after refilling it. Chance nodes enumerate the distinct
+// refills from the unseen tiles exactly instead of sampling them.
+//
+// Depth 1 scores the refilled hand by the bot's leave terms (synergy and
+// duplicates). That value depends only on the unseen counts and the kept
+// tiles, so it is cached per (unseen counts, hand) and shared by every move
+// that keeps the same tiles. Depth 2 replaces the hand score with the best
+// depth-1 move on the new board, ignoring the opponents' turn in between.
+// Each of its outcomes costs a move generation, so it is reserved for small
+// refills: late in the game or when the candidates play one or two tiles.
+//
+// Like Searcher, it stops on a wall-clock budget or stop() from another
+// thread, polling an atomic flag between root candidates, refill outcomes
+// and move-generation start cells. A stopped depth-2 pass is dropped for the
+// depth-1 ranking; a stopped ranking keeps the moves valued so far, and root
+// generation only polls once it has found a move.
+class ExpectimaxBot {
+public:
+    explicit ExpectimaxBot(const EvalWeights& weights = defaultWeights()) : heuristic(weights), weights(weights) {}
+
+    // Empty move when there is nothing legal (a pass)
+    Move choose(const GameState& state, const ExpectimaxLimits& limits = {});
+
+    void stop() { stopFlag.store(true, std::memory_order_relaxed); }
+    // The last choose() hit its budget or stop() and cut its search short
+    bool lastStopped() const { return stopped; }
+
+    // Expected leave value of keeping `kept` and drawing `draws` tiles from `pool`.
+    // Inside choose() it returns 0 once stopped.
+    double chanceValue(const expectimax::KindCounts& pool, const expectimax::KindCounts& kept, int draws);
+
+    // Leave terms of a hand, weighted
+    double handValue(const expectimax::KindCounts& hand) const;
+
+    std::uint64_t chanceNodes() const { return nodes; }     // chance nodes expanded
+    std::uint64_t outcomesVisited() const { return outcomes; }
+    std::uint64_t cacheHits() const { return hits; }
+    std::uint64_t deepDecisions() const { return deepCount; } // choose() calls that ran depth 2
+    void clearCache() { cache.clear(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr std::size_t CACHE_LIMIT = 1 << 20; // entries; cleared when full
+    static constexpr unsigned CLOCK_CHECK_INTERVAL = 4; // polls between clock reads
+
+    struct ChanceKey {
+        expectimax::KindCounts pool, kept;
+        std::uint8_t draws;
+        bool operator==(const ChanceKey& o) const { return pool == o.pool && kept == o.kept && draws == o.draws; }
+    };
+    struct ChanceKeyHash {
+        std::size_t operator()(const ChanceKey& k) const;
+    };
+
+    // Move value with the leave terms replaced by the chance node below it
+    double moveValue(const Board& board, const Hand& hand, const Move& move,
+                     const expectimax::KindCounts& pool, int bagSize, int depth);
+    // Best move value on `board` holding `hand`; the hand's value on a pass
+    // Both return 0 once stopped; callers check the flag.
+    double bestValue(const Board& board, const expectimax::KindCounts& hand,
+                     const expectimax::KindCounts& pool, int bagSize, int depth);
+
+    HeuristicBot heuristic; // for the board terms
+    EvalWeights weights;
+    std::unordered_map<ChanceKey, double, ChanceKeyHash> cache;
+    std::vector<expectimax::Draw> drawStack[2]; // per depth, reused
+    MoveList moveStack[2];
+    std::uint64_t nodes = 0, outcomes = 0, hits = 0, deepCount = 0;
+
+    // `readClock` skips the poll interval, for polls between coarse steps
+    bool shouldStop(bool readClock = false);
+    std::atomic<bool> stopFlag{false};
+    std::function<bool()> stopCheck{ [this] { return shouldStop(true); } };
+    Clock::time_point deadline;
+    bool hasDeadline = false;
+    unsigned pollCount = 0;
+    bool searching = false; // only choose() stops early
+    bool stopped = false;
+};
@@ -0,0 +1,38 @@
+#include "FrameStats.h"
+#include <algorithm>
+#include <ostream>
+
+void FrameStats::addFrame(double millis, int drawCalls) {
+    frameMillis.push_back(millis);
+    frameDrawCalls.push_back(drawCalls);
+}
+
+void FrameStats::writeJson(std::ostream& out) const {
+    out << "{\"frames\": " << frameMillis.size();
+    if (frameMillis.empty()) {
+        out << "}\n";
+        return;
+    }
+
+    std::vector<double> sorted = frameMillis;
+    std::sort(sorted.begin(), sorted.end());
+    auto percentile = [&](double p) {
+        return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+    };
+    double total = 0;
+    for (double ms : sorted) total += ms;
+    long long calls = 0;
+    int maxCalls = 0;
+    for (int c : frameDrawCalls) {
+        calls += c;
+        maxCalls = std::max(maxCalls, c);
+    }
+
+    out << ", \"frame_ms\": {\"mean\": " << total / sorted.size()
+        << ", \"p50\": " << percentile(0.50)
+        << ", \"p90\": " << percentile(0.90)
+        << ", \"p99\": " << percentile(0.99)
+        << ", \"max\": " << sorted.back() << "}"
+        << ", \"draw_calls\": {\"mean\": " << static_cast<double>(calls) / frameDrawCalls.size()
+        << ", \"max\": " << maxCalls << ", \"total\": " << calls << "}}\n";
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <iosfwd>
+#include <vector>
+
+// Per-frame timings and draw-call counts collected by the render loop,
+// summarised as a distribution for frame-loop benchmarks.
+class FrameStats {
+public:
+    void addFrame(double millis, int drawCalls);
+    size_t frameCount() const { return frameMillis.size(); }
+
+    // JSON summary: frame-time percentiles, mean, max and draw calls per frame
+    void writeJson(std::ostream& out) const;
+
+private:
+    std::vector<double> frameMillis;
+    std::vector<int> frameDrawCalls;
+};
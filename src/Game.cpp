@@ -1,61 +1,36 @@
 #include "Game.h"
+#include "InputRecording.h"
+#include "Rules.h"
+#include "SaveGame.h"
+#include "TextureAtlas.h"
 #include <algorithm>
 #include <cmath>
+#include <fstream>
 #include <iostream>
-
-// Helper name maps for filename generation - adjust to your naming convention
-static const std::map<Shape, std::string> shapeNames = {
-    {Shape::Circle, "O"},
-    {Shape::Square, "S"},
-    {Shape::Diamond, "D"},
-    {Shape::Astericks, "A"},
-    {Shape::Clover, "C"},
-    {Shape::Fourpoint,  "F"}
-};
-
-static const std::map<Color, std::string> colorNames = {
-    {Color::Red,    "r"},
-    {Color::Orange, "o"},
-    {Color::Yellow, "y"},
-    {Color::Green,  "g"},
-    {Color::Blue,   "b"},
-    {Color::Purple, "p"}
-};
+#include <set>
+#include <sstream>
 
 // Game constants (mirrors Game.h)
 constexpr int Game::TILE_SIZE;
 constexpr int Game::BUTTON_WIDTH;
 constexpr int Game::BUTTON_HEIGHT;
 constexpr int Game::HAND_SLOT_PADDING;
-
-static std::string joinPath(const std::string& a, const std::string& b) {
-    if (a.empty()) return b;
-    if (a.back() == '/') return a + b;
-    return a + "/" + b;
-}
-
-std::string Game::getTextureFilename(Shape s, Color c, const std::string& assetsDir) {
-    // e.g. assetsDir + "/rO.png" or "rO.png" depending on naming (color+shape)
-    std::string filename = colorNames.at(c) + shapeNames.at(s) + ".png";
-    return joinPath(assetsDir, filename);
-}
+constexpr float Game::DRAG_THRESHOLD;
+constexpr unsigned Game::HINT_TEXT_SIZE;
 
 bool Game::loadTextures(const std::string& assetsDir) {
     int loaded = 0;
-    for (auto const& sn : shapeNames) {
-        for (auto const& cn : colorNames) {
-            Shape s = sn.first;
-            Color c = cn.first;
-            std::string fname = getTextureFilename(s, c, assetsDir);
-            sf::Texture tex;
-            if (!tex.loadFromFile(fname)) {
-                std::cerr << "Warning: failed to load texture: " << fname << "\n";
-                continue;
-            }
-            tex.setSmooth(true);
-            tileTextures[{s, c}] = std::move(tex);
-            loaded+=1;
+    for (int i = 0; i < TILE_KINDS; ++i) {
+        Tile t = tileFromIndex(i);
+        std::string fname = TextureAtlas::tileFilename(t.shape, t.color, assetsDir);
+        sf::Texture tex;
+        if (!tex.loadFromFile(fname)) {
+            std::cerr << "Warning: failed to load texture: " << fname << "\n";
+            continue;
         }
+        tex.setSmooth(true);
+        tileTextures[{t.shape, t.color}] = std::move(tex);
+        loaded+=1;
     }
     if (loaded == 0) {
         std::cerr << "Error: no tile textures loaded from '" << assetsDir << "'.\n";
@@ -65,28 +40,48 @@ bool Game::loadTextures(const std::string& assetsDir) {
     return true;
 }
 
-void Game::initTileBag() {
-    tileBag.clear();
-    tileBag.reserve(108);
-    for (const auto& shape : { Shape::Circle, Shape::Square, Shape::Diamond, Shape::Astericks, Shape::Clover, Shape::Fourpoint }) {
-        for (const auto& color : { Color::Red, Color::Orange, Color::Yellow, Color::Green, Color::Blue, Color::Purple }) {
-            for (int copy = 0; copy < 3; ++copy) {
-                tileBag.push_back(Tile{ shape, color });
-            }
-        }
+void Game::selectHandSlot(int index) {
+    if (index < 0 || index >= static_cast<int>(playerHand().size()) || !playerHand()[index].has_value()) {
+        return; // clicked empty slot: do nothing
+    }
+    // select this tile (toggle)
+    if (selectedHandIndex == index) selectedHandIndex = -1;
+    else selectedHandIndex = index;
+    hintsDirty = true;
+    logAction("select " + std::to_string(index));
+}
+
+void Game::stageSelectedTile(const Coord& cell) {
+    if (selectedHandIndex < 0 || selectedHandIndex >= static_cast<int>(playerHand().size())
+        || !playerHand()[selectedHandIndex].has_value()) {
+        return;
+    }
+    // don't allow placing on occupied board or already staged spot
+    if (state.board.isOccupied(cell.first, cell.second) || stagedTiles.find(cell) != stagedTiles.end()) {
+        return;
     }
-    std::shuffle(tileBag.begin(), tileBag.end(), rng);
+    // place staged tile
+    stagedTiles[cell] = playerHand()[selectedHandIndex].value();
+    // remove from hand (slot becomes empty)
+    playerHand()[selectedHandIndex] = std::nullopt;
+    // clear selection
+    selectedHandIndex = -1;
+    hintsDirty = true;
+    logAction("stage " + std::to_string(cell.first) + " " + std::to_string(cell.second));
 }
 
-Tile Game::drawTileFromBag() {
-    if (tileBag.empty()) {
-        // In a real game, handle empty bag appropriately (return dummy or throw)
-        // We'll return a fallback red circle if empty
-        return Tile{Shape::Circle, Color::Red};
+void Game::confirmMove() {
+    // Commit staged tiles
+    for (auto const& p : stagedTiles) {
+        state.board.placeTile(p.first.first, p.first.second, p.second);
     }
-    Tile t = tileBag.back();
-    tileBag.pop_back();
-    return t;
+    stagedTiles.clear();
+
+    // Refill hand to 6
+    state.refillHand(0);
+    selectedHandIndex = -1;
+    hintsDirty = true;
+    logAction("commit");
 }
 
 void Game::resetUnconfirmedTiles() {
@@ -96,11 +91,11 @@ void Game::resetUnconfirmedTiles() {
         bool placedInHand = false;
 
         // Ensure hand has size 6 (should already, but be safe)
-        if (playerHand.size() != 6) playerHand.assign(6, std::nullopt);
+        if (playerHand().size() != 6) playerHand().assign(6, std::nullopt);
 
-        for (size_t i = 0; i < playerHand.size(); ++i) {
-            if (!playerHand[i].has_value()) {
-                playerHand[i] = t;
+        for (size_t i = 0; i < playerHand().size(); ++i) {
+            if (!playerHand()[i].has_value()) {
+                playerHand()[i] = t;
                 placedInHand = true;
                 break;
             }
@@ -108,26 +103,112 @@ void Game::resetUnconfirmedTiles() {
 
         if (!placedInHand) {
             // No empty slot found (shouldn't normally happen) — return tile to the bag.
-            tileBag.push_back(t);
+            state.tileBag.push_back(t);
         }
     }
 
     // Clear staged tiles and reset selection.
     stagedTiles.clear();
     selectedHandIndex = -1;
+    hintsDirty = true;
+    logAction("reset");
 }
 
-void Game::refillHand() {
-    // Ensure playerHand size is 6
-    if (playerHand.size() != 6) playerHand.assign(6, std::nullopt);
-
-    for (size_t i = 0; i < playerHand.size(); ++i) {
-        if (!playerHand[i].has_value() && !tileBag.empty()) {
-            playerHand[i] = drawTileFromBag();
+void Game::startAutosave(const std::string& directory, bool freshStart) {
+    journal = std::make_unique<Journal>(directory);
+    if (freshStart) journal->discard();
+
+    std::string snapshot;
+    std::vector<std::string> actions;
+    bool restored = false;
+    if (journal->restore(snapshot, actions) && restoreSession(snapshot)) {
+        restoring = true;
+        for (const std::string& a : actions) {
+            if (!applyAction(a)) {
+                std::cerr << "Warning: autosave journal entry '" << a << "' ignored\n";
+            }
         }
+        restoring = false;
+        restored = true;
+        std::cout << "Restored autosaved game (" << actions.size() << " actions after snapshot).\n";
+    }
+
+    if (!journal->start()) {
+        journal.reset();
+    } else if (!restored) {
+        // Fresh game: the first snapshot is the base the journal replays onto
+        journal->snapshot(serializeSession());
     }
 }
 
+void Game::logAction(const std::string& action) {
+    if (!journal || restoring) return;
+    journal->append(action);
+    if (journal->pendingSinceSnapshot() >= SNAPSHOT_EVERY) {
+        journal->snapshot(serializeSession());
+    }
+}
+
+bool Game::applyAction(const std::string& action) {
+    std::istringstream in(action);
+    std::string verb;
+    in >> verb;
+    if (verb == "select") {
+        int index;
+        if (!(in >> index)) return false;
+        selectHandSlot(index);
+    } else if (verb == "stage") {
+        int x, y;
+        if (!(in >> x >> y)) return false;
+        stageSelectedTile({x, y});
+    } else if (verb == "commit") {
+        confirmMove();
+    } else if (verb == "reset") {
+        resetUnconfirmedTiles();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Game state followed by the UI-only parts of the turn in progress:
+//     staged N    then N lines "x y tile"
+//     selected I
+std::string Game::serializeSession() const {
+    std::ostringstream out;
+    savegame::writeText(out, state);
+    out << "staged " << stagedTiles.size() << "\n";
+    for (const auto& p : stagedTiles) {
+        out << p.first.first << ' ' << p.first.second << ' ' << tileIndex(p.second) << "\n";
+    }
+    out << "selected " << selectedHandIndex << "\n";
+    return out.str();
+}
+
+bool Game::restoreSession(const std::string& text) {
+    std::istringstream in(text);
+    GameState loaded(1, 0);
+    if (!savegame::readText(in, loaded)) return false;
+
+    std::string word;
+    size_t count = 0;
+    if (!(in >> word >> count) || word != "staged") return false;
+    TileMap staged;
+    for (size_t i = 0; i < count; ++i) {
+        int x, y, index;
+        if (!(in >> x >> y >> index) || index < 0 || index >= TILE_KINDS) return false;
+        staged[{x, y}] = tileFromIndex(index);
+    }
+    int selected = -1;
+    if (!(in >> word >> selected) || word != "selected") return false;
+
+    state = loaded;
+    stagedTiles = staged;
+    selectedHandIndex = selected;
+    hintsDirty = true;
+    return true;
+}
+
 void Game::drawTile(sf::RenderWindow& window, int x, int y, const Tile& tile) {
     auto it = tileTextures.find({tile.shape, tile.color});
     if (it != tileTextures.end()) {
@@ -137,13 +218,14 @@ void Game::drawTile(sf::RenderWindow& window, int x, int y, const Tile& tile) {
         float scaleX = static_cast<float>(TILE_SIZE) / static_cast<float>(tex.getSize().x);
         float scaleY = static_cast<float>(TILE_SIZE) / static_cast<float>(tex.getSize().y);
         sprite.setScale(scaleX, scaleY);
-        window.draw(sprite);
+        drawCounted(window, sprite);
         return;
     }
 }
 
-bool Game::pointInRect(sf::Vector2f point, sf::RectangleShape& rect) {
-    return rect.getGlobalBounds().contains(point);
+void Game::drawCounted(sf::RenderWindow& window, const sf::Drawable& drawable) {
+    window.draw(drawable);
+    ++drawCalls;
 }
 
 Coord Game::worldToBoard(const sf::Vector2f& worldPos) {
@@ -152,40 +234,178 @@ Coord Game::worldToBoard(const sf::Vector2f& worldPos) {
     return {bx, by};
 }
 
-void Game::drawHand(sf::RenderWindow& window, const sf::Font& font) {
+void Game::setupUi() {
+    confirmBtn.setSize(sf::Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
+    confirmBtn.setFillColor(sf::Color(100, 200, 100));
+    confirmText = sf::Text("Confirm Move", font, 12);
+    confirmText.setFillColor(sf::Color::Black);
+
+    exitBtn.setSize(sf::Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
+    exitBtn.setFillColor(sf::Color(200, 100, 100));
+    exitText = sf::Text("Exit Game", font, 12);
+    exitText.setFillColor(sf::Color::Black);
+
+    resetHandBtn.setSize(sf::Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
+    resetHandBtn.setFillColor(sf::Color(200, 200, 100));
+    resetHandText = sf::Text("Reset Hand", font, 12);
+    resetHandText.setFillColor(sf::Color::Black);
+
+    bagCountText.setFont(font);
+    bagCountText.setCharacterSize(20);
+    bagCountText.setFillColor(sf::Color::Black);
+
+    for (int i = 0; i < HAND_SIZE; ++i) {
+        handSlotBgs[i].setSize(sf::Vector2f(static_cast<float>(TILE_SIZE), static_cast<float>(TILE_SIZE)));
+        handSlotBgs[i].setFillColor(sf::Color(230, 230, 230));
+        handSlotBgs[i].setOutlineThickness(2);
+        handSlotBgs[i].setOutlineColor(sf::Color::Black);
+        emptySlotLabels[i] = sf::Text("-", font, 18);
+        emptySlotLabels[i].setFillColor(sf::Color(120, 120, 120));
+    }
+    handHighlight.setSize(sf::Vector2f(static_cast<float>(TILE_SIZE)+6, static_cast<float>(TILE_SIZE)+6));
+    handHighlight.setFillColor(sf::Color::Transparent);
+    handHighlight.setOutlineThickness(3);
+    handHighlight.setOutlineColor(sf::Color(50, 200, 50));
+
+    stagedOutline.setSize(sf::Vector2f(static_cast<float>(TILE_SIZE - 4), static_cast<float>(TILE_SIZE - 4)));
+    stagedOutline.setFillColor(sf::Color::Transparent);
+    stagedOutline.setOutlineThickness(3);
+    stagedOutline.setOutlineColor(sf::Color(50, 200, 50));
+
+    hintLabels.bake(font, HINT_TEXT_SIZE);
+    hintLabels.setColor(sf::Color(30, 120, 30, 200));
+}
+
+void Game::applyLayout(sf::Vector2u windowSize) {
+    float w = static_cast<float>(windowSize.x), h = static_cast<float>(windowSize.y);
+    uiView.reset(sf::FloatRect(0, 0, w, h));
+    if (!layout.update(windowSize)) return;
+
+    auto place = [&](sf::RectangleShape& button, sf::Text& text, int region, float textX) {
+        const sf::FloatRect& r = layout.rect(region);
+        button.setPosition(r.left, r.top);
+        text.setPosition(r.left + textX, r.top + 8.f);
+    };
+    place(confirmBtn, confirmText, Layout::CONFIRM, 10.f);
+    place(exitBtn, exitText, Layout::EXIT, 10.f);
+    place(resetHandBtn, resetHandText, Layout::RESET, 10.f);
+    const sf::FloatRect& bag = layout.rect(Layout::BAG_COUNT);
+    bagCountText.setPosition(bag.left, bag.top);
+    for (int i = 0; i < HAND_SIZE; ++i) {
+        const sf::FloatRect& slot = layout.rect(Layout::HAND_SLOT + i);
+        handSlotBgs[i].setPosition(slot.left, slot.top);
+        emptySlotLabels[i].setPosition(slot.left + TILE_SIZE/2 - 6, slot.top + TILE_SIZE/2 - 12);
+    }
+}
+
+void Game::armDrag(int index, sf::Vector2f screenPos, sf::Vector2f slotPos) {
+    dragHandIndex = index;
+    dragStart = dragPosition = screenPos;
+    dragOffset = screenPos - slotPos;
+}
+
+void Game::startDrag() {
+    if (!playerHand()[dragHandIndex].has_value()) { // hand changed under the press
+        cancelDrag();
+        return;
+    }
+    isDraggingTile = true;
+    draggedTile = playerHand()[dragHandIndex].value();
+    hintsDirty = true;
+    auto it = tileTextures.find({draggedTile.shape, draggedTile.color});
+    if (it != tileTextures.end()) {
+        const sf::Texture& tex = it->second;
+        dragSprite.setTexture(tex, true);
+        dragSprite.setScale(static_cast<float>(TILE_SIZE) / static_cast<float>(tex.getSize().x),
+                            static_cast<float>(TILE_SIZE) / static_cast<float>(tex.getSize().y));
+    }
+    previewShown = false;
+}
+
+void Game::cancelDrag() {
+    if (isDraggingTile) hintsDirty = true;
+    isDraggingTile = false;
+    dragHandIndex = -1;
+    previewShown = false;
+}
+
+void Game::updatePreview(bool overBoard, const Coord& cell) {
+    if (!overBoard) {
+        previewShown = false;
+        return;
+    }
+    if (previewShown && cell == previewCell) return;
+    previewShown = true;
+    previewCell = cell;
+
+    // Legal if the staged tiles plus this one would make a valid move
+    bool legal = !state.board.isOccupied(cell.first, cell.second) && stagedTiles.find(cell) == stagedTiles.end()
+                 && static_cast<int>(stagedTiles.size()) < Move::MAX_TILES;
+    if (legal) {
+        Move move;
+        for (const auto& p : stagedTiles) move.add({p.first, p.second});
+        move.add({cell, draggedTile});
+        legal = rules::validateMove(state.board, move);
+    }
+    sf::Color color = legal ? sf::Color(50, 200, 50) : sf::Color(220, 60, 60);
+    previewRect.setSize(sf::Vector2f(static_cast<float>(TILE_SIZE - 4), static_cast<float>(TILE_SIZE - 4)));
+    previewRect.setPosition(static_cast<float>(cell.first * TILE_SIZE + 2), static_cast<float>(cell.second * TILE_SIZE + 2));
+    previewRect.setFillColor(sf::Color(color.r, color.g, color.b, 60));
+    previewRect.setOutlineThickness(2);
+    previewRect.setOutlineColor(color);
+}
+
+void Game::updateHints() {
+    hintsDirty = false;
+    hintLabels.clear();
+    const Tile* tile = nullptr;
+    if (isDraggingTile) tile = &draggedTile;
+    else if (selectedHandIndex >= 0 && playerHand()[selectedHandIndex].has_value()) tile = &*playerHand()[selectedHandIndex];
+    if (!tile || static_cast<int>(stagedTiles.size()) >= Move::MAX_TILES) return;
+
+    // Only cells next to a tile can be legal. The opening tile can go
+    // anywhere, so an empty turn on an empty board gets no hints.
+    Move move;
+    for (const auto& p : stagedTiles) move.add({p.first, p.second});
+    std::set<Coord> candidates;
+    auto addNeighbours = [&](const Coord& c) {
+        const Coord around[4] = {{c.first + 1, c.second}, {c.first - 1, c.second},
+                                 {c.first, c.second + 1}, {c.first, c.second - 1}};
+        for (const Coord& n : around) {
+            if (!state.board.isOccupied(n.first, n.second) && stagedTiles.find(n) == stagedTiles.end()) {
+                candidates.insert(n);
+            }
+        }
+    };
+    for (const auto& p : state.board.getTiles()) addNeighbours(p.first);
+    for (const auto& p : stagedTiles) addNeighbours(p.first);
+
+    for (const Coord& c : candidates) {
+        Move tryMove = move;
+        tryMove.add({c, *tile});
+        if (!rules::validateMove(state.board, tryMove)) continue;
+        sf::Vector2f center((c.first + 0.5f) * TILE_SIZE, (c.second + 0.5f) * TILE_SIZE);
+        hintLabels.add(center, rules::scoreMove(state.board, tryMove));
+    }
+}
+
+void Game::drawHand(sf::RenderWindow& window) {
     // Draw playerHand centered at bottom above buttons
-    const float screenW = static_cast<float>(window.getSize().x);
-    const float screenH = static_cast<float>(window.getSize().y);
-
-    // Each slot width
-    float slotW = static_cast<float>(TILE_SIZE) + HAND_SLOT_PADDING;
-    float totalW = slotW * 6 - HAND_SLOT_PADDING; // six slots
-    float startX = (screenW - totalW) / 2.0f;
-    float y = screenH - static_cast<float>(TILE_SIZE) - 10.0f; // 10px top margin from bottom
-
-    for (int i = 0; i < 6; ++i) {
-        float x = startX + i * slotW;
-        // Draw slot background
-        sf::RectangleShape slotBg(sf::Vector2f(static_cast<float>(TILE_SIZE), static_cast<float>(TILE_SIZE)));
-        slotBg.setPosition(x, y);
-        slotBg.setFillColor(sf::Color(230, 230, 230));
-        slotBg.setOutlineThickness(2);
-        slotBg.setOutlineColor(sf::Color::Black);
-        window.draw(slotBg);
+    for (int i = 0; i < HAND_SIZE; ++i) {
+        const sf::FloatRect& slot = layout.rect(Layout::HAND_SLOT + i);
+        float x = slot.left, y = slot.top;
+        drawCounted(window, handSlotBgs[i]);
 
         // If this slot is selected, draw highlight
         if (i == selectedHandIndex) {
-            sf::RectangleShape highlight(sf::Vector2f(static_cast<float>(TILE_SIZE)+6, static_cast<float>(TILE_SIZE)+6));
-            highlight.setPosition(x - 3, y - 3);
-            highlight.setFillColor(sf::Color::Transparent);
-            highlight.setOutlineThickness(3);
-            highlight.setOutlineColor(sf::Color(50, 200, 50));
-            window.draw(highlight);
+            handHighlight.setPosition(x - 3, y - 3);
+            drawCounted(window, handHighlight);
         }
 
-        // Draw tile if exists
-        if (i < static_cast<int>(playerHand.size()) && playerHand[i].has_value()) {
-            Tile t = playerHand[i].value();
+        // Draw tile if exists; a dragged one is drawn at the pointer instead
+        if (isDraggingTile && i == dragHandIndex) continue;
+        if (i < static_cast<int>(playerHand().size()) && playerHand()[i].has_value()) {
+            Tile t = playerHand()[i].value();
             // Try to draw texture; we need to draw using screen coords (hand UI)
             auto it = tileTextures.find({t.shape, t.color});
             if (it != tileTextures.end()) {
@@ -196,24 +416,38 @@ void Game::drawHand(sf::RenderWindow& window, const sf::Font& font) {
                 float scaleY = static_cast<float>(TILE_SIZE) / static_cast<float>(tex.getSize().y);
                 sprite.setScale(scaleX, scaleY);
                 // Draw in default view space; caller must ensure default view is set
-                window.draw(sprite);
+                drawCounted(window, sprite);
             }
         } else {
-            // empty slot label
-            sf::Text label("-", font, 18);
-            label.setFillColor(sf::Color(120, 120, 120));
-            label.setPosition(x + TILE_SIZE/2 - 6, y + TILE_SIZE/2 - 12);
-            window.draw(label);
+            drawCounted(window, emptySlotLabels[i]);
         }
     }
 }
 
-void Game::run() {
+void Game::run(const RunOptions& options) {
+    // Input recording / playback; the bag seed is stored with the recording
+    // so a replay deals the same tiles
+    InputRecorder recorder;
+    InputPlayback playback;
+    std::uint32_t seed = std::random_device{}();
+    if (!options.replayPath.empty()) {
+        if (!playback.load(options.replayPath)) return;
+        seed = playback.getSeed();
+    } else if (!options.recordPath.empty()) {
+        recorder.open(options.recordPath, seed);
+    }
+    state = GameState(1, seed);
+    state.deal();
+    // A recording replays from a fresh deal of its seed, so it can't start
+    // from a restored session. Recorded sessions aren't autosaved, and the
+    // saved game is left for the next normal start.
+    bool autosave = options.replayPath.empty() && !recorder.isOpen() && !options.autosaveDir.empty();
+    if (autosave) startAutosave(options.autosaveDir, options.freshStart);
+
     sf::RenderWindow window(sf::VideoMode(1024, 768), "Qwirkle");
     sf::View view = window.getDefaultView();
 
     // Load font for buttons & hand
-    sf::Font font;
     if (!font.loadFromFile("/System/Library/Fonts/Supplemental/Arial.ttf")) {
         std::cerr << "Failed to load system font; button/hand text may not show.\n";
     }
@@ -223,134 +457,86 @@ void Game::run() {
         loadTextures("../assets/tiles"); // fallback when running from build dir
     }
 
-    // Initialize bag and hand
-    initTileBag();
-    playerHand.assign(6, std::nullopt);
-    refillHand();
-
-    // Setup buttons bottom-left (screen coords)
-
-    sf::RectangleShape resetHandBtn(sf::Vector2f(150, 40));
-    resetHandBtn.setFillColor(sf::Color(200, 200, 200));
-    resetHandBtn.setPosition(200.f, window.getSize().y - BUTTON_HEIGHT - 10.f);
-
-    sf::Text resetHandText("Reset Hand", font, 12);
-    resetHandText.setFillColor(sf::Color::Black);
-    resetHandText.setPosition(resetHandBtn.getPosition().x + 20.f, resetHandBtn.getPosition().y + 8.f);
-
-    sf::RectangleShape confirmBtn(sf::Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-    confirmBtn.setFillColor(sf::Color(100, 200, 100));
-    confirmBtn.setPosition(10.f, window.getSize().y - BUTTON_HEIGHT - 10.f);
-
-    sf::Text confirmText("Confirm Move", font, 12);
-    confirmText.setFillColor(sf::Color::Black);
-    confirmText.setPosition(confirmBtn.getPosition().x + 10.f, confirmBtn.getPosition().y + 8.f);
-
-    sf::RectangleShape exitBtn(sf::Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-    exitBtn.setFillColor(sf::Color(200, 100, 100));
-    exitBtn.setPosition(20.f + BUTTON_WIDTH, window.getSize().y - BUTTON_HEIGHT - 10.f);
-
-    sf::Text exitText("Exit Game", font, 12);
-    exitText.setFillColor(sf::Color::Black);
-    exitText.setPosition(exitBtn.getPosition().x + 10.f, exitBtn.getPosition().y + 8.f);
+    // Buttons bottom-left, hand bottom-center (screen coords, placed by the layout)
+    setupUi();
+    applyLayout(window.getSize());
 
     bool rightMouseDown = false;
     sf::Vector2i lastMousePos;
 
+    sf::Clock sessionClock;
+    sf::Clock frameClock;
+    std::uint32_t frame = 0;
+    std::vector<sf::Event> frameEvents;
+
     while (window.isOpen()) {
+        frameClock.restart();
+        drawCalls = 0;
+
         // Set view so mapPixelToCoords uses the current camera
         window.setView(view);
 
-        sf::Event event;
-        while (window.pollEvent(event)) {
+        // Gather this frame's input: live from the window, or from the
+        // recording (live input is then ignored apart from closing)
+        frameEvents.clear();
+        sf::Event polled;
+        while (window.pollEvent(polled)) {
+            if (playback.isLoaded()) {
+                if (polled.type == sf::Event::Closed) window.close();
+                continue;
+            }
+            if (recorder.isOpen()) recorder.record(frame, sessionClock.getElapsedTime().asMicroseconds(), polled);
+            frameEvents.push_back(polled);
+        }
+        if (playback.isLoaded()) playback.eventsForFrame(frame, frameEvents);
+
+        for (const sf::Event& event : frameEvents) {
             switch (event.type) {
                 case sf::Event::Closed:
                     window.close();
                     break;
 
+                case sf::Event::Resized:
+                    // Keep the camera centre and zoom; the UI follows the new size
+                    view.setSize(static_cast<float>(event.size.width), static_cast<float>(event.size.height));
+                    applyLayout({event.size.width, event.size.height});
+                    break;
+
                 case sf::Event::MouseButtonPressed:
                     if (event.mouseButton.button == sf::Mouse::Left) {
                         sf::Vector2i pixelPos(event.mouseButton.x, event.mouseButton.y);
                         sf::Vector2f worldPos = window.mapPixelToCoords(pixelPos); // respects current view
                         sf::Vector2f screenPos(static_cast<float>(pixelPos.x), static_cast<float>(pixelPos.y));
 
-                        // Check UI buttons (use screen coords and default view)
-                        // NOTE: UI is drawn in default view; so check in that space
-                        window.setView(window.getDefaultView());
-                        if (confirmBtn.getGlobalBounds().contains(screenPos)) {
-                            // Commit staged tiles
-                            for (auto const& p : stagedTiles) {
-                                board.placeTile(p.first.first, p.first.second, p.second);
-                            }
-                            stagedTiles.clear();
-
-                            // Refill hand to 6
-                            refillHand();
-                            selectedHandIndex = -1;
-                            // restore view
-                            window.setView(view);
+                        // UI first, in screen coords from the cached layout
+                        int region = layout.hit(screenPos);
+                        if (region == Layout::CONFIRM) {
+                            confirmMove();
                             break;
                         }
-                        if (exitBtn.getGlobalBounds().contains(screenPos)) {
+                        if (region == Layout::EXIT) {
                             window.close();
                             break;
                         }
-                        if (resetHandBtn.getGlobalBounds().contains(screenPos)) {
+                        if (region == Layout::RESET) {
+                            // stop processing this click (so we don't also interpret it as hand/board click)
                             resetUnconfirmedTiles();
-
-                            // restore view and stop processing this click (so we don't also interpret it as hand/board click)
-                            window.setView(view);
                             break;
                         }
-                        // Also check if player clicked on the hand area (screen coords)
-                        // We'll use drawHand geometry to find which slot was clicked.
-                        // compute hand slot positions same as drawHand
-                        const float screenW = static_cast<float>(window.getSize().x);
-                        const float screenH = static_cast<float>(window.getSize().y);
-                        float slotW = static_cast<float>(TILE_SIZE) + HAND_SLOT_PADDING;
-                        float totalW = slotW * 6 - HAND_SLOT_PADDING;
-                        float startX = (screenW - totalW) / 2.0f;
-                        float y = screenH - static_cast<float>(TILE_SIZE) - 10.0f;
-
-                        // If click falls in hand vertical band
-                        if (screenPos.y >= y && screenPos.y <= y + TILE_SIZE) {
-                            for (int i = 0; i < 6; ++i) {
-                                float x = startX + i * slotW;
-                                if (screenPos.x >= x && screenPos.x <= x + TILE_SIZE) {
-                                    // clicked slot i
-                                    if (playerHand[i].has_value()) {
-                                        // select this tile (toggle)
-                                        if (selectedHandIndex == i) selectedHandIndex = -1;
-                                        else selectedHandIndex = i;
-                                    } else {
-                                        // clicked empty slot: do nothing
-                                    }
-                                    break;
-                                }
+                        // Hand: a press on a tile arms a drag, which becomes a
+                        // select on release if the pointer didn't move
+                        if (region >= Layout::HAND_SLOT && region < Layout::HAND_SLOT + 6) {
+                            int slot = region - Layout::HAND_SLOT;
+                            if (slot < static_cast<int>(playerHand().size()) && playerHand()[slot].has_value()) {
+                                const sf::FloatRect& r = layout.rect(region);
+                                armDrag(slot, screenPos, sf::Vector2f(r.left, r.top));
                             }
-                            // restore view and continue
-                            window.setView(view);
                             break;
                         }
-
-                        // Restore view for board interactions
-                        window.setView(view);
+                        if (region >= 0) break; // between hand slots
 
                         // If a hand tile is selected, place it to world (board coords) as staged tile
-                        if (selectedHandIndex >= 0 && selectedHandIndex < static_cast<int>(playerHand.size())
-                            && playerHand[selectedHandIndex].has_value()) {
-                            Coord boardCoord = worldToBoard(worldPos);
-                            // don't allow placing on occupied board or already staged spot
-                            if (!board.isOccupied(boardCoord.first, boardCoord.second)
-                                && stagedTiles.find(boardCoord) == stagedTiles.end()) {
-                                // place staged tile
-                                stagedTiles[boardCoord] = playerHand[selectedHandIndex].value();
-                                // remove from hand (slot becomes empty)
-                                playerHand[selectedHandIndex] = std::nullopt;
-                                // clear selection
-                                selectedHandIndex = -1;
-                            }
-                        }
+                        stageSelectedTile(worldToBoard(worldPos));
 
                     } else if (event.mouseButton.button == sf::Mouse::Right) {
                         rightMouseDown = true;
@@ -358,13 +544,56 @@ void Game::run() {
                     }
                     break;
 
+                case sf::Event::KeyPressed:
+                    if (event.key.code == sf::Keyboard::F5) {
+                        // Quicksave the committed game; staged tiles go back to the hand first
+                        resetUnconfirmedTiles();
+                        if (savegame::saveToFile(QUICKSAVE_PATH, state, savegame::Format::Binary)) {
+                            std::cout << "Saved game to '" << QUICKSAVE_PATH << "'.\n";
+                        } else {
+                            std::cerr << "Error: could not save game to '" << QUICKSAVE_PATH << "'\n";
+                        }
+                    } else if (event.key.code == sf::Keyboard::F9) {
+                        if (savegame::loadFromFile(QUICKSAVE_PATH, state)) {
+                            stagedTiles.clear();
+                            selectedHandIndex = -1;
+                            hintsDirty = true;
+                            if (journal) journal->snapshot(serializeSession());
+                            std::cout << "Loaded game from '" << QUICKSAVE_PATH << "'.\n";
+                        } else {
+                            std::cerr << "Error: could not load game from '" << QUICKSAVE_PATH << "'\n";
+                        }
+                    }
+                    break;
+
                 case sf::Event::MouseButtonReleased:
                     if (event.mouseButton.button == sf::Mouse::Right) {
                         rightMouseDown = false;
+                    } else if (event.mouseButton.button == sf::Mouse::Left && dragHandIndex >= 0) {
+                        int slot = dragHandIndex;
+                        if (!isDraggingTile) {
+                            selectHandSlot(slot);
+                        } else if (previewShown) {
+                            // Dropped on the board: journaled as select + stage,
+                            // the same actions as click placement
+                            if (selectedHandIndex != slot) selectHandSlot(slot);
+                            stageSelectedTile(previewCell);
+                        }
+                        cancelDrag();
                     }
                     break;
 
                 case sf::Event::MouseMoved:
+                    if (dragHandIndex >= 0) {
+                        sf::Vector2i pixelPos(event.mouseMove.x, event.mouseMove.y);
+                        dragPosition = sf::Vector2f(static_cast<float>(pixelPos.x), static_cast<float>(pixelPos.y));
+                        sf::Vector2f moved = dragPosition - dragStart;
+                        if (!isDraggingTile && std::abs(moved.x) + std::abs(moved.y) > DRAG_THRESHOLD) startDrag();
+                        if (isDraggingTile) {
+                            updatePreview(layout.hit(dragPosition) < 0,
+                                          worldToBoard(window.mapPixelToCoords(pixelPos, view)));
+                        }
+                    }
                     if (rightMouseDown) {
                         sf::Vector2i newPos(event.mouseMove.x, event.mouseMove.y);
                         sf::Vector2f delta = window.mapPixelToCoords(lastMousePos) - window.mapPixelToCoords(newPos);
@@ -386,7 +615,7 @@ void Game::run() {
         window.setView(view);
 
         // Draw already-committed tiles
-        for (auto const& p : board.getTiles()) {
+        for (auto const& p : state.board.getTiles()) {
             drawTile(window, p.first.first, p.first.second, p.second);
         }
 
@@ -396,57 +625,57 @@ void Game::run() {
             drawTile(window, p.first.first, p.first.second, p.second);
 
             // draw outline rect to indicate staging
-            sf::RectangleShape outline(sf::Vector2f(static_cast<float>(TILE_SIZE - 4), static_cast<float>(TILE_SIZE - 4)));
-            outline.setPosition(static_cast<float>(p.first.first * TILE_SIZE), static_cast<float>(p.first.second * TILE_SIZE));
-            outline.setFillColor(sf::Color::Transparent);
-            outline.setOutlineThickness(3);
-            outline.setOutlineColor(sf::Color(50, 200, 50));
-            window.draw(outline);
+            stagedOutline.setPosition(static_cast<float>(p.first.first * TILE_SIZE), static_cast<float>(p.first.second * TILE_SIZE));
+            drawCounted(window, stagedOutline);
         }
 
-        // UI in default view (hand + buttons)
-        window.setView(window.getDefaultView());
+        // Score hints for the tile in hand, one draw call for all of them
+        if (hintsDirty) updateHints();
+        if (!hintLabels.empty()) drawCounted(window, hintLabels);
+
+        // Where a dragged tile would land
+        if (isDraggingTile && previewShown) drawCounted(window, previewRect);
+
+        // UI in screen coords; widgets were placed by applyLayout
+        window.setView(uiView);
         // draw hand (centered bottom)
-        drawHand(window, font);
-
-        // draw "Confirm Move" button
-        sf::RectangleShape confirmBtnLocal(sf::Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-        confirmBtnLocal.setFillColor(sf::Color(100, 200, 100));
-        confirmBtnLocal.setPosition(10.f, window.getSize().y - BUTTON_HEIGHT - 10.f);
-        window.draw(confirmBtnLocal);
-        window.draw(confirmText);
-
-        // draw "Exit Game" button
-        sf::RectangleShape exitBtnLocal(sf::Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-        exitBtnLocal.setFillColor(sf::Color(200, 100, 100));
-        exitBtnLocal.setPosition(20.f + BUTTON_WIDTH, window.getSize().y - BUTTON_HEIGHT - 10.f);
-        window.draw(exitBtnLocal);
-        window.draw(exitText);
-
-        // draw "Reset Hand" button
-        sf::RectangleShape resetHandBtnLocal(sf::Vector2f(BUTTON_WIDTH, BUTTON_HEIGHT));
-        resetHandBtnLocal.setFillColor(sf::Color(200, 200, 100));
-        resetHandBtnLocal.setPosition(30.f + BUTTON_WIDTH * 2, window.getSize().y - BUTTON_HEIGHT - 10.f);
-        window.draw(resetHandBtnLocal);
-        window.draw(resetHandText);
-
-        // Display remaining tiles count in bottom right
-        sf::Text bagCountText;
-        bagCountText.setFont(font);
-        bagCountText.setCharacterSize(20);
-        bagCountText.setFillColor(sf::Color::Black);
-
-        std::string bagText = "Tiles left: " + std::to_string(tileBag.size());
-        bagCountText.setString(bagText);
-
-        // Position in bottom-right corner
-        sf::FloatRect textBounds = bagCountText.getLocalBounds();
-        bagCountText.setOrigin(textBounds.width, 0); // right-align
-        bagCountText.setPosition(window.getSize().x - 10.f, window.getSize().y - BUTTON_HEIGHT - 10.f); 
-
-        window.draw(bagCountText);
+        drawHand(window);
+
+        drawCounted(window, confirmBtn);
+        drawCounted(window, confirmText);
+        drawCounted(window, exitBtn);
+        drawCounted(window, exitText);
+        drawCounted(window, resetHandBtn);
+        drawCounted(window, resetHandText);
+
+        // Remaining tiles count, right-aligned on its cached anchor; the text
+        // is only rebuilt when the count changes
+        if (state.tileBag.size() != shownBagCount) {
+            shownBagCount = state.tileBag.size();
+            bagCountText.setString("Tiles left: " + std::to_string(shownBagCount));
+            bagCountText.setOrigin(bagCountText.getLocalBounds().width, 0);
+        }
+        drawCounted(window, bagCountText);
 
+        // Dragged tile last, over everything, at this frame's pointer position
+        if (isDraggingTile) {
+            dragSprite.setPosition(dragPosition - dragOffset);
+            drawCounted(window, dragSprite);
+        }
 
         window.display();
+
+        frameStats.addFrame(frameClock.getElapsedTime().asMicroseconds() / 1000.0, drawCalls);
+        ++frame;
+        if (playback.isLoaded() && playback.finished()) window.close();
+    }
+
+    if (!options.statsPath.empty()) {
+        if (options.statsPath == "-") {
+            frameStats.writeJson(std::cout);
+        } else {
+            std::ofstream out(options.statsPath);
+            frameStats.writeJson(out);
+        }
     }
 }
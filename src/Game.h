@@ -1,45 +1,102 @@
 #pragma once
 
-#include "Board.h"
+#include "FrameStats.h"
+#include "GameState.h"
+#include "Journal.h"
+#include "Layout.h"
+#include "ScoreLabels.h"
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstddef>
 #include <map>
+#include <memory>
 #include <optional>
-#include <random>
 #include <string>
 #include <vector>
 
+// Command-line options for a session
+struct RunOptions {
+    std::string recordPath; // write input events here
+    std::string replayPath; // replay input events from here instead of the user
+    std::string statsPath;  // frame-time / draw-call JSON ("-" for stdout)
+    std::string autosaveDir = "autosave"; // empty disables autosave
+    bool freshStart = false; // ignore (and replace) any autosaved session
+};
+
 class Game {
 public:
     Game() = default;
-    void run();
+    void run(const RunOptions& options = {});
 
 private:
-    Board board;
+    // Board, bag and the single local player's hand
+    GameState state{1};
+    Hand& playerHand() { return state.hands[0]; }
 
     // Textures for drawing tiles
     std::map<std::pair<Shape, Color>, sf::Texture> tileTextures;
     bool loadTextures(const std::string& assetsDir);
     void drawTile(sf::RenderWindow& window, int x, int y, const Tile& tile);
 
-    // Bag & hand
-    std::vector<Tile> tileBag;
-    std::mt19937 rng{std::random_device{}()};
-    void initTileBag();
-    Tile drawTileFromBag(); // assumes bag not empty
-    void refillHand();
+    // All drawing goes through here so frames can report their draw calls
+    void drawCounted(sf::RenderWindow& window, const sf::Drawable& drawable);
+    int drawCalls = 0;
+    FrameStats frameStats;
+
+    // Player actions. Each one is journaled so a restart can replay it.
+    void selectHandSlot(int index); // toggles
+    void stageSelectedTile(const Coord& cell);
+    void confirmMove();
     void resetUnconfirmedTiles();
 
-    // Drag-and-drop state
-    // bool isDraggingTile = false;
-    // int dragHandIndex = -1;  // Which slot in the hand we’re dragging from
-    // sf::Vector2f dragOffset; // Offset from mouse to tile center
-    // Tile draggedTile;        // Copy of the tile being dragged
+    // Explicit save/load (F5 / F9)
+    static constexpr const char* QUICKSAVE_PATH = "quicksave.qwk";
+
+    // Autosave
+    static constexpr int SNAPSHOT_EVERY = 32; // journaled actions between snapshots
+    std::unique_ptr<Journal> journal;
+    bool restoring = false; // replaying the journal: don't log again
+    void startAutosave(const std::string& directory, bool freshStart);
+    void logAction(const std::string& action); // call after the action is applied
+    bool applyAction(const std::string& action);
+    std::string serializeSession() const;
+    bool restoreSession(const std::string& text);
+
+    // Drag-and-drop state. A press on a hand tile arms a drag; moving past
+    // DRAG_THRESHOLD starts it, and releasing over the board stages the tile
+    // there. Pressing and releasing without moving is a click (select).
+    static constexpr float DRAG_THRESHOLD = 4.0f; // pixels
+    bool isDraggingTile = false;
+    int dragHandIndex = -1;   // Which slot in the hand we’re dragging from
+    sf::Vector2f dragOffset;  // Offset from mouse to tile top-left
+    sf::Vector2f dragStart;   // Screen position of the press
+    sf::Vector2f dragPosition; // Latest pointer position, drawn the same frame
+    Tile draggedTile{};       // Copy of the tile being dragged
+    sf::Sprite dragSprite;    // set up when the drag starts; only moved per frame
+    void armDrag(int index, sf::Vector2f screenPos, sf::Vector2f slotPos);
+    void startDrag();
+    void cancelDrag();
+
+    // Snap preview under a dragged tile: the cell it would land on, coloured
+    // by whether the turn so far plus this tile is legal. Recomputed only
+    // when the pointer enters another cell.
+    bool previewShown = false;
+    Coord previewCell{0, 0};
+    sf::RectangleShape previewRect;
+    sf::RectangleShape stagedOutline; // styled once, moved onto each staged tile
+    void updatePreview(bool overBoard, const Coord& cell);
 
-    // Player hand: 6 slots, optional if empty
-    std::vector<std::optional<Tile>> playerHand; // size 6
+    // Score hints: every cell where the selected (or dragged) tile could go
+    // this turn, labelled with what the turn would then score. Rebuilt only
+    // after an action marks them dirty.
+    static constexpr unsigned HINT_TEXT_SIZE = 20;
+    ScoreLabels hintLabels;
+    bool hintsDirty = true;
+    void updateHints();
 
     // Selection & staged placements
     int selectedHandIndex = -1; // -1 none selected
-    std::map<Coord, Tile> stagedTiles; // temporary placements for this turn
+    TileMap stagedTiles; // temporary placements for this turn
 
     // UI constants
     static constexpr int TILE_SIZE = 64;
@@ -47,12 +104,23 @@ private:
     static constexpr int BUTTON_HEIGHT = 40;
     static constexpr int HAND_SLOT_PADDING = 6;
 
-    // UI helpers
-    bool pointInRect(sf::Vector2f point, sf::RectangleShape& rect);
-    std::string getTextureFilename(Shape s, Color c, const std::string& assetsDir);
+    // UI geometry, recomputed only when the window is resized; drawing and
+    // hit-testing both read it
+    Layout layout{Layout::Metrics{TILE_SIZE, HAND_SLOT_PADDING, BUTTON_WIDTH, BUTTON_HEIGHT, 10}};
+    sf::View uiView; // screen pixels, follows the window size
+    sf::Font font;
+    sf::RectangleShape confirmBtn, exitBtn, resetHandBtn;
+    sf::Text confirmText, exitText, resetHandText, bagCountText;
+    std::size_t shownBagCount = SIZE_MAX; // count bagCountText was laid out for
+    // Hand widgets, styled once and placed by applyLayout
+    std::array<sf::RectangleShape, HAND_SIZE> handSlotBgs;
+    std::array<sf::Text, HAND_SIZE> emptySlotLabels;
+    sf::RectangleShape handHighlight;
+    void setupUi();
+    void applyLayout(sf::Vector2u windowSize); // resize: views, layout, widgets
 
     // Draw the bottom hand
-    void drawHand(sf::RenderWindow& window, const sf::Font& font);
+    void drawHand(sf::RenderWindow& window);
 
     // Helper: convert world coords to board coords (flooring)
     static Coord worldToBoard(const sf::Vector2f& worldPos);
@@ -0,0 +1,87 @@
+#include "GameHost.h"
+#include "Rules.h"
+
+namespace {
+
+// The player holds every tile the move places
+bool handHolds(const Hand& hand, const Move& move) {
+    int counts[TILE_KINDS] = {};
+    for (const auto& slot : hand) {
+        if (slot) ++counts[tileIndex(*slot)];
+    }
+    for (const Placement& p : move) {
+        if (--counts[tileIndex(p.tile)] < 0) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+GameHost::GameHost(Executor& executor, RequestHandler onRequest, int capacity)
+    : executor(executor), onRequest(std::move(onRequest)), slots(capacity > 0 ? capacity : 0) {}
+
+GameHost::~GameHost() {
+    for (int i = 0; i < started; ++i) {
+        if (slots[i].waiting) slots[i].waiting.destroy();
+    }
+}
+
+int GameHost::addGame(std::uint32_t seed, int players) {
+    if (started == static_cast<int>(slots.size())) return -1;
+    int game = started++;
+    Task task = play(*this, game, seed, players);
+    executor.post(game, task.handle);
+    return game;
+}
+
+void GameHost::MoveAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    Slot& slot = host.slots[game];
+    slot.awaiter = this;
+    slot.waiting = handle;
+    host.onRequest({ game, state.currentPlayer, &state });
+}
+
+Move GameHost::MoveAwaiter::await_resume() const {
+    return move;
+}
+
+void GameHost::deliver(int game, const Move& move) {
+    Slot& slot = slots[game];
+    std::coroutine_handle<> handle = slot.waiting;
+    slot.awaiter->move = move;
+    slot.waiting = nullptr;
+    slot.awaiter = nullptr;
+    executor.post(game, handle);
+}
+
+GameHost::Task GameHost::play(GameHost& host, int game, std::uint32_t seed, int players) {
+    GameState state(players, seed);
+    state.board.trackLines(); // for the bots' threat terms
+    state.deal();
+    int passes = 0;
+    while (!state.isGameOver() && passes < state.playerCount()) {
+        Move m = co_await MoveAwaiter{ host, game, state, {} };
+        if (!m.empty() && (!rules::validateMove(state.board, m) || !handHolds(state.hand(), m))) {
+            host.rejected.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        passes = m.empty() ? passes + 1 : 0;
+        state.applyMove(m);
+        host.moves.fetch_add(1, std::memory_order_relaxed);
+    }
+    host.finish(game, state);
+}
+
+void GameHost::finish(int game, const GameState& state) {
+    {
+        std::lock_guard<std::mutex> lock(resultMutex);
+        results[game] = state.scores;
+    }
+    finished.fetch_add(1);
+}
+
+std::vector<int> GameHost::result(int game) const {
+    std::lock_guard<std::mutex> lock(resultMutex);
+    auto it = results.find(game);
+    return it != results.end() ? it->second : std::vector<int>{};
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include "Executor.h"
+#include "GameState.h"
+#include "Move.h"
+#include <atomic>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// A turn that needs a move from outside: a human or a remote bot. `state`
+// stays valid and unchanged until the move is delivered.
+struct MoveRequest {
+    int game;
+    int player;
+    const GameState* state;
+};
+
+// Hosts many games at once, each written as a coroutine that suspends while
+// it waits for a move. A waiting game is only its coroutine frame and a slot
+// here: no thread, no queue entry. Delivering a move queues the game on the
+// executor, which validates and applies it and then asks for the next one.
+// Requires C++20.
+class GameHost {
+public:
+    // Called on an executor thread whenever a game waits for a move
+    using RequestHandler = std::function<void(const MoveRequest&)>;
+
+    // Room for `capacity` games, allocated up front so ids stay stable
+    GameHost(Executor& executor, RequestHandler onRequest, int capacity);
+    // Frees the games still waiting; the executor must be stopped first
+    ~GameHost();
+    GameHost(const GameHost&) = delete;
+    GameHost& operator=(const GameHost&) = delete;
+
+    // Starts a dealt game; returns its id, or -1 when the host is full.
+    // Not thread-safe with itself.
+    int addGame(std::uint32_t seed, int players = 2);
+
+    // Resumes `game` with the current player's move (empty = pass). Moves
+    // that are illegal or use tiles the player lacks are rejected and asked
+    // for again. Callable from any thread, once per request.
+    void deliver(int game, const Move& move);
+
+    int gameCount() const { return started; }
+    int finishedCount() const { return finished.load(); }
+    long long movesPlayed() const { return moves.load(); }
+    long long movesRejected() const { return rejected.load(); }
+    // Final scores of a finished game, empty while it runs
+    std::vector<int> result(int game) const;
+
+    // Coroutine type of a hosted game: starts suspended, frees itself on return
+    struct Task {
+        struct promise_type {
+            Task get_return_object() { return { std::coroutine_handle<promise_type>::from_promise(*this) }; }
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() {}
+            void unhandled_exception() { std::terminate(); }
+        };
+        std::coroutine_handle<promise_type> handle;
+    };
+
+    // co_await target inside a game: suspends until deliver() fills `move`
+    struct MoveAwaiter {
+        GameHost& host;
+        int game;
+        const GameState& state;
+        Move move;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        Move await_resume() const;
+    };
+
+private:
+    // Per game; the move and everything else live in the coroutine frame
+    struct Slot {
+        std::coroutine_handle<> waiting; // null while running or finished
+        MoveAwaiter* awaiter = nullptr;
+    };
+
+    static Task play(GameHost& host, int game, std::uint32_t seed, int players);
+    void finish(int game, const GameState& state);
+
+    Executor& executor;
+    RequestHandler onRequest;
+    std::vector<Slot> slots;
+    int started = 0;
+    mutable std::mutex resultMutex;
+    std::map<int, std::vector<int>> results; // finished games only
+    std::atomic<int> finished{0};
+    std::atomic<long long> moves{0}, rejected{0};
+};
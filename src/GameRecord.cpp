@@ -0,0 +1,76 @@
+#include "GameRecord.h"
+#include <fstream>
+#include <istream>
+#include <ostream>
+#include <sstream>
+
+GameState GameRecord::replay(size_t count) const {
+    GameState state(players, seed);
+    state.deal();
+    for (size_t i = 0; i < moves.size() && i < count; ++i) {
+        state.applyMove(moves[i]);
+    }
+    return state;
+}
+
+std::string formatMove(const Move& move) {
+    if (move.empty()) return "pass";
+    std::string text;
+    for (const Placement& p : move) {
+        if (!text.empty()) text += ' ';
+        text += std::to_string(p.pos.first) + ',' + std::to_string(p.pos.second) + ',' + std::to_string(tileIndex(p.tile));
+    }
+    return text;
+}
+
+bool parseMove(const std::string& text, Move& move) {
+    move = Move{};
+    if (text == "pass") return true;
+    std::istringstream in(text);
+    std::string token;
+    while (in >> token) {
+        int x, y, index;
+        char c1, c2;
+        std::istringstream tok(token);
+        if (!(tok >> x >> c1 >> y >> c2 >> index) || c1 != ',' || c2 != ',') return false;
+        if (index < 0 || index >= TILE_KINDS || move.size() == Move::MAX_TILES) return false;
+        move.add({{x, y}, tileFromIndex(index)});
+    }
+    return !move.empty();
+}
+
+void GameRecord::write(std::ostream& out) const {
+    out << "qwirkle-record 1\n";
+    out << "seed " << seed << " players " << players << "\n";
+    for (const Move& m : moves) out << formatMove(m) << "\n";
+}
+
+bool GameRecord::read(std::istream& in) {
+    std::string magic, seedWord, playersWord;
+    int version = 0;
+    if (!(in >> magic >> version) || magic != "qwirkle-record" || version != 1) return false;
+    if (!(in >> seedWord >> seed >> playersWord >> players) || seedWord != "seed" || playersWord != "players") return false;
+    if (players < 1) return false;
+
+    moves.clear();
+    std::string line;
+    std::getline(in, line); // rest of header line
+    while (std::getline(in, line)) {
+        if (line.empty()) break; // blank line ends a record in an archive
+        Move m;
+        if (!parseMove(line, m)) return false;
+        moves.push_back(m);
+    }
+    return true;
+}
+
+bool readArchive(const std::string& path, std::vector<GameRecord>& games) {
+    std::ifstream in(path);
+    if (!in) return false;
+    while (in >> std::ws, in.peek() != EOF) {
+        GameRecord record;
+        if (!record.read(in)) return false;
+        games.push_back(std::move(record));
+    }
+    return true;
+}
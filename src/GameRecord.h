@@ -0,0 +1,32 @@
+#pragma once
+#include "GameState.h"
+#include "Move.h"
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// A game as its seed (which fixes the deal and bag order) plus the moves
+// played; an empty move is a pass. Text form, one move per line:
+//     qwirkle-record 1
+//     seed 42 players 2
+//     0,0,7 1,0,9
+//     pass
+// where each placement is x,y,tileIndex.
+struct GameRecord {
+    std::uint32_t seed = 0;
+    int players = 2;
+    std::vector<Move> moves;
+
+    // Deal from the seed and apply the first `count` moves (all by default)
+    GameState replay(size_t count = SIZE_MAX) const;
+
+    void write(std::ostream& out) const;
+    bool read(std::istream& in); // false on malformed input
+};
+
+// Reads every record of an archive (records separated by blank lines)
+bool readArchive(const std::string& path, std::vector<GameRecord>& games);
+
+std::string formatMove(const Move& move);
+bool parseMove(const std::string& text, Move& move);
@@ -0,0 +1,84 @@
+#include "GameState.h"
+#include "Rules.h"
+#include <algorithm>
+
+GameState::GameState(int players, std::uint32_t seed)
+    : hands(players, Hand(HAND_SIZE)), scores(players, 0), rng(seed) {}
+
+GameState::GameState(const GameState& other, std::pmr::memory_resource* resource)
+    : board(other.board, resource), tileBag(other.tileBag), hands(other.hands), scores(other.scores),
+      currentPlayer(other.currentPlayer), rng(other.rng), gameOver(other.gameOver) {}
+
+void GameState::initTileBag() {
+    tileBag.clear();
+    tileBag.reserve(TOTAL_TILES);
+    for (const auto& shape : { Shape::Circle, Shape::Square, Shape::Diamond, Shape::Astericks, Shape::Clover, Shape::Fourpoint }) {
+        for (const auto& color : { Color::Red, Color::Orange, Color::Yellow, Color::Green, Color::Blue, Color::Purple }) {
+            for (int copy = 0; copy < TILES_PER_KIND; ++copy) {
+                tileBag.push_back(Tile{ shape, color });
+            }
+        }
+    }
+    std::shuffle(tileBag.begin(), tileBag.end(), rng);
+}
+
+Tile GameState::drawTileFromBag() {
+    if (tileBag.empty()) {
+        // In a real game, handle empty bag appropriately (return dummy or throw)
+        // We'll return a fallback red circle if empty
+        return Tile{Shape::Circle, Color::Red};
+    }
+    Tile t = tileBag.back();
+    tileBag.pop_back();
+    return t;
+}
+
+void GameState::refillHand(int player) {
+    Hand& h = hands[player];
+    // Ensure hand size is 6
+    if (h.size() != HAND_SIZE) h.assign(HAND_SIZE, std::nullopt);
+
+    for (size_t i = 0; i < h.size(); ++i) {
+        if (!h[i].has_value() && !tileBag.empty()) {
+            h[i] = drawTileFromBag();
+        }
+    }
+}
+
+void GameState::deal() {
+    bool tracksLines = board.tracksOpenLines();
+    board = Board(board.getResource());
+    if (tracksLines) board.trackLines();
+    initTileBag();
+    for (int p = 0; p < playerCount(); ++p) {
+        hands[p].assign(HAND_SIZE, std::nullopt);
+        refillHand(p);
+        scores[p] = 0;
+    }
+    currentPlayer = 0;
+    gameOver = false;
+}
+
+int GameState::applyMove(const Move& move) {
+    int points = move.empty() ? 0 : rules::scoreMove(board, move);
+    Hand& h = hand();
+    for (const Placement& p : move) {
+        board.placeTile(p.pos.first, p.pos.second, p.tile);
+        for (auto& slot : h) {
+            if (slot && *slot == p.tile) {
+                slot.reset();
+                break;
+            }
+        }
+    }
+    refillHand(currentPlayer);
+
+    bool handEmpty = std::none_of(h.begin(), h.end(), [](const std::optional<Tile>& s) { return s.has_value(); });
+    if (!move.empty() && handEmpty && tileBag.empty()) {
+        points += rules::GOING_OUT_BONUS;
+        gameOver = true;
+    }
+    scores[currentPlayer] += points;
+    currentPlayer = (currentPlayer + 1) % playerCount();
+    return points;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "Board.h"
+#include "Move.h"
+#include "Rng.h"
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <vector>
+
+constexpr int HAND_SIZE = 6;
+constexpr int TILES_PER_KIND = 3;
+constexpr int TOTAL_TILES = TILE_KINDS * TILES_PER_KIND;
+constexpr int MAX_PLAYERS = TOTAL_TILES / HAND_SIZE; // every hand can be dealt full
+
+// Hand slots: HAND_SIZE entries, empty once a tile is played
+using Hand = std::vector<std::optional<Tile>>;
+
+// Headless game state shared by the GUI, bots and tools: board, bag,
+// per-player hands and scores. Copyable so searches can branch from it.
+struct GameState {
+    explicit GameState(int players = 1, std::uint32_t seed = std::random_device{}());
+    GameState(const GameState&) = default;
+    // Copy whose board allocates from `resource`, e.g. a search's arena
+    GameState(const GameState& other, std::pmr::memory_resource* resource);
+
+    Board board;
+    std::vector<Tile> tileBag; // drawn from the back
+    std::vector<Hand> hands;
+    std::vector<int> scores;
+    int currentPlayer = 0;
+    Rng rng;
+
+    int playerCount() const { return static_cast<int>(hands.size()); }
+    Hand& hand() { return hands[currentPlayer]; }
+    const Hand& hand() const { return hands[currentPlayer]; }
+
+    void initTileBag();
+    Tile drawTileFromBag(); // assumes bag not empty
+    void refillHand(int player);
+    // Fresh shuffled bag and full hands for every player
+    void deal();
+
+    // Play a move for the current player: place its tiles, take them out of
+    // the hand, add the score, refill from the bag and pass the turn. An empty
+    // move is a pass. Assumes the move was validated. Returns points scored.
+    int applyMove(const Move& move);
+
+    // A player emptied their hand with nothing left to draw
+    bool isGameOver() const { return gameOver; }
+    bool gameOver = false;
+};
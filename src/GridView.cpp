@@ -0,0 +1,205 @@
+#include "GridView.h"
+#include "HeuristicBot.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+const float GAP = 0.004f;           // between boards, as a fraction of the window
+const float MIN_SPAN = 7.0f;        // tiles across an almost empty board
+const double RESTART_SECONDS = 2.0; // finished game stays up this long
+
+} // namespace
+
+GridView::GridView(const GridOptions& options)
+    : options(options), nextSeed(options.seed),
+      buffer(sf::Quads, sf::VertexBuffer::Dynamic), backgrounds(sf::Quads) {
+    int count = std::max(1, options.columns) * std::max(1, options.rows);
+    boards.resize(count);
+    vertices.resize(static_cast<size_t>(count) * SLICE);
+    for (int b = 0; b < count; ++b) startGame(b, nextSeed++);
+}
+
+GridView::~GridView() {
+    while (inFlight.load() > 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void GridView::startGame(int board, std::uint32_t seed) {
+    Slot& s = boards[board];
+    s.state = GameState(2, seed);
+    s.state.board.trackLines();
+    s.state.deal();
+    s.tiles = 0;
+    s.passes = 0;
+    s.minX = s.maxX = s.minY = s.maxY = 0;
+    fitView(board);
+}
+
+void GridView::requestMove(int board) {
+    // The render thread leaves the state alone until the move comes back
+    Slot& s = boards[board];
+    s.thinking = true;
+    inFlight.fetch_add(1);
+    const GameState* state = &s.state;
+    ThreadPool::shared().submit([this, board, state] {
+        HeuristicBot bot;
+        Move move = bot.choose(*state);
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            results.push_back(Result{ board, std::move(move) });
+        }
+        inFlight.fetch_sub(1);
+    }, TaskPriority::Interactive);
+}
+
+void GridView::applyMove(int board, const Move& move) {
+    Slot& s = boards[board];
+    s.thinking = false;
+    s.passes = move.empty() ? s.passes + 1 : 0;
+    int first = s.tiles;
+    for (const Placement& p : move) writeTile(board, p.pos.first, p.pos.second, p.tile);
+    s.state.applyMove(move);
+    if (useBuffer && s.tiles > first) {
+        size_t offset = static_cast<size_t>(board) * SLICE + static_cast<size_t>(first) * QUAD;
+        buffer.update(&vertices[offset], static_cast<size_t>(s.tiles - first) * QUAD, static_cast<unsigned>(offset));
+    }
+    if (!move.empty()) fitView(board);
+}
+
+void GridView::writeTile(int board, int x, int y, const Tile& tile) {
+    Slot& s = boards[board];
+    if (s.tiles == TOTAL_TILES) return;
+    if (s.tiles == 0) {
+        s.minX = s.maxX = x;
+        s.minY = s.maxY = y;
+    } else {
+        s.minX = std::min(s.minX, x);
+        s.maxX = std::max(s.maxX, x);
+        s.minY = std::min(s.minY, y);
+        s.maxY = std::max(s.maxY, y);
+    }
+    atlas.writeQuad(&vertices[static_cast<size_t>(board) * SLICE + static_cast<size_t>(s.tiles) * QUAD], x, y, tile);
+    ++s.tiles;
+}
+
+void GridView::fitView(int board) {
+    // World units are tiles; keep them square in the board's viewport
+    Slot& s = boards[board];
+    float w = std::max(MIN_SPAN, static_cast<float>(s.maxX - s.minX + 2));
+    float h = std::max(MIN_SPAN, static_cast<float>(s.maxY - s.minY + 2));
+    if (w / h < cellAspect) w = h * cellAspect;
+    else h = w / cellAspect;
+    s.view.setCenter((s.minX + s.maxX + 1) / 2.0f, (s.minY + s.maxY + 1) / 2.0f);
+    s.view.setSize(w, h);
+}
+
+void GridView::layout(sf::Vector2u windowSize) {
+    int cols = std::max(1, options.columns), rows = std::max(1, options.rows);
+    float cellW = 1.0f / cols, cellH = 1.0f / rows;
+    float width = static_cast<float>(windowSize.x), height = static_cast<float>(windowSize.y);
+    cellAspect = (cellW - 2 * GAP) * width / std::max(1.0f, (cellH - 2 * GAP) * height);
+    screen.reset(sf::FloatRect(0, 0, width, height));
+
+    backgrounds.clear();
+    for (int b = 0; b < static_cast<int>(boards.size()); ++b) {
+        sf::FloatRect port((b % cols) * cellW + GAP, (b / cols) * cellH + GAP, cellW - 2 * GAP, cellH - 2 * GAP);
+        boards[b].view.setViewport(port);
+        fitView(b);
+
+        float left = port.left * width, top = port.top * height;
+        float right = left + port.width * width, bottom = top + port.height * height;
+        sf::Color felt(232, 232, 224);
+        backgrounds.append(sf::Vertex(sf::Vector2f(left, top), felt));
+        backgrounds.append(sf::Vertex(sf::Vector2f(right, top), felt));
+        backgrounds.append(sf::Vertex(sf::Vector2f(right, bottom), felt));
+        backgrounds.append(sf::Vertex(sf::Vector2f(left, bottom), felt));
+    }
+}
+
+void GridView::drawBoard(sf::RenderWindow& window, int board) {
+    const Slot& s = boards[board];
+    if (s.tiles == 0) return;
+    window.setView(s.view);
+    sf::RenderStates states(&atlas.texture());
+    size_t first = static_cast<size_t>(board) * SLICE;
+    size_t count = static_cast<size_t>(s.tiles) * QUAD;
+    if (useBuffer) window.draw(buffer, first, count, states);
+    else window.draw(&vertices[first], count, sf::Quads, states);
+    ++drawCalls;
+}
+
+void GridView::run() {
+    if (!atlas.load("assets/tiles") && !atlas.load("../assets/tiles")) return;
+
+    sf::RenderWindow window(sf::VideoMode(1280, 960), "Qwirkle - bot games");
+    window.setVerticalSyncEnabled(true);
+    useBuffer = sf::VertexBuffer::isAvailable() && buffer.create(vertices.size());
+    layout(window.getSize());
+
+    sf::Clock clock;
+    sf::Clock frameClock;
+    double moveSeconds = options.moveMillis / 1000.0;
+
+    while (window.isOpen()) {
+        frameClock.restart();
+        drawCalls = 0;
+
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed) {
+                window.close();
+            } else if (event.type == sf::Event::Resized) {
+                layout({ event.size.width, event.size.height });
+            }
+        }
+
+        // Moves the bots finished since the last frame
+        {
+            std::lock_guard<std::mutex> lock(resultMutex);
+            applying.swap(results);
+        }
+        double now = clock.getElapsedTime().asSeconds();
+        for (const Result& r : applying) {
+            applyMove(r.board, r.move);
+            boards[r.board].nextAt = now + moveSeconds;
+            const GameState& state = boards[r.board].state;
+            if (state.isGameOver() || boards[r.board].passes >= state.playerCount()) {
+                boards[r.board].nextAt = now + RESTART_SECONDS;
+            }
+        }
+        applying.clear();
+
+        for (int b = 0; b < static_cast<int>(boards.size()); ++b) {
+            Slot& s = boards[b];
+            if (s.thinking || now < s.nextAt) continue;
+            if (s.state.isGameOver() || s.passes >= s.state.playerCount()) {
+                startGame(b, nextSeed++);
+                s.nextAt = now + moveSeconds;
+            } else {
+                requestMove(b);
+            }
+        }
+
+        window.clear(sf::Color(60, 60, 60));
+        window.setView(screen);
+        window.draw(backgrounds);
+        ++drawCalls;
+        for (int b = 0; b < static_cast<int>(boards.size()); ++b) drawBoard(window, b);
+        window.display();
+
+        frameStats.addFrame(frameClock.getElapsedTime().asMicroseconds() / 1000.0, drawCalls);
+    }
+
+    if (!options.statsPath.empty()) {
+        if (options.statsPath == "-") {
+            frameStats.writeJson(std::cout);
+        } else {
+            std::ofstream out(options.statsPath);
+            frameStats.writeJson(out);
+        }
+    }
+}
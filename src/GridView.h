@@ -0,0 +1,87 @@
+#pragma once
+
+#include "FrameStats.h"
+#include "GameState.h"
+#include "Move.h"
+#include "TextureAtlas.h"
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Command-line options for the grid of watched games
+struct GridOptions {
+    int columns = 8;
+    int rows = 8;
+    int moveMillis = 250;   // pause between a board's moves
+    std::uint32_t seed = 1; // board i starts with seed + i
+    std::string statsPath;  // frame-time / draw-call JSON ("-" for stdout)
+};
+
+// A window of live heuristic-bot games, one board per grid cell. Every tile
+// of every board lives in one vertex buffer textured from the tile atlas,
+// with a fixed slice per board; a move writes just its new quads. Each board
+// is drawn as its slice through its own view, which zooms to fit the tiles,
+// so nothing already on screen is rebuilt when a board grows or the window
+// is resized.
+class GridView {
+public:
+    explicit GridView(const GridOptions& options);
+    // Waits for bot moves still being computed
+    ~GridView();
+    GridView(const GridView&) = delete;
+    GridView& operator=(const GridView&) = delete;
+
+    void run();
+
+private:
+    static constexpr int QUAD = 4;
+    static constexpr int SLICE = TOTAL_TILES * QUAD; // vertices per board
+
+    struct Slot {
+        GameState state{2};
+        int tiles = 0; // quads written to the slice
+        int passes = 0;
+        int minX = 0, maxX = 0, minY = 0, maxY = 0; // tile bounds
+        sf::View view;
+        double nextAt = 0; // clock time of the next move or restart
+        bool thinking = false;
+    };
+
+    // A finished bot move, handed from a pool worker to the render thread
+    struct Result {
+        int board;
+        Move move;
+    };
+
+    void startGame(int board, std::uint32_t seed);
+    void requestMove(int board);
+    void applyMove(int board, const Move& move);
+    void writeTile(int board, int x, int y, const Tile& tile);
+    void fitView(int board);
+    // Backgrounds and viewports for the window size
+    void layout(sf::Vector2u windowSize);
+    void drawBoard(sf::RenderWindow& window, int board);
+
+    GridOptions options;
+    TextureAtlas atlas;
+    std::vector<Slot> boards;
+    std::uint32_t nextSeed;
+
+    std::vector<sf::Vertex> vertices; // CPU copy of the buffer
+    sf::VertexBuffer buffer;
+    bool useBuffer = false; // false: draw straight from `vertices`
+    sf::VertexArray backgrounds; // in window pixels, drawn through `screen`
+    sf::View screen;
+    float cellAspect = 1.0f; // width / height of a board's viewport
+
+    std::mutex resultMutex;
+    std::vector<Result> results;
+    std::vector<Result> applying; // swapped with `results` each frame
+    std::atomic<int> inFlight{0};
+
+    int drawCalls = 0;
+    FrameStats frameStats;
+};
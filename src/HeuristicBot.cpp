@@ -0,0 +1,107 @@
+#include "HeuristicBot.h"
+#include "MoveGen.h"
+#include "Rules.h"
+#include <cstddef>
+#include <memory_resource>
+
+namespace {
+
+// Whether the 5-long line the move makes through `p` can still be completed,
+// read from the open lines of a scratch copy of the board with the move on it
+bool staysOpen(const Board& board, const Move& move, const Placement& p, bool vertical) {
+    alignas(std::max_align_t) char buffer[16 << 10];
+    std::pmr::monotonic_buffer_resource scratch(buffer, sizeof buffer);
+    Board after(board, &scratch);
+    for (const Placement& q : move) after.placeTile(q.pos.first, q.pos.second, q.tile);
+    int start = after.segmentAt(p.pos.first, p.pos.second, vertical)->start;
+    Coord first = vertical ? Coord{ p.pos.first, start } : Coord{ start, p.pos.second };
+    return after.getOpenLines().count(LineKey{ first, vertical }) != 0;
+}
+
+} // namespace
+
+const char* termName(int term) {
+    static const char* names[TERM_COUNT] = { "score", "leave_synergy", "leave_duplicates", "qwirkle_threat", "open_lines" };
+    return names[term];
+}
+
+EvalWeights defaultWeights() {
+    EvalWeights w{};
+    w[TermScore] = 1.0;
+    w[TermLeaveSynergy] = 0.3;
+    w[TermLeaveDuplicates] = -1.0;
+    w[TermQwirkleThreat] = -4.0;
+    w[TermOpenLines] = -0.5;
+    return w;
+}
+
+std::array<double, TERM_COUNT> HeuristicBot::terms(const Board& board, const Hand& hand, const Move& move) const {
+    return terms(board, hand, move, rules::scoreMove(board, move));
+}
+
+std::array<double, TERM_COUNT> HeuristicBot::terms(const Board& board, const Hand& hand, const Move& move, int score) const {
+    std::array<double, TERM_COUNT> t{};
+    t[TermScore] = score;
+
+    // Tiles kept after the move
+    int counts[TILE_KINDS] = {};
+    for (const auto& slot : hand) {
+        if (slot) ++counts[tileIndex(*slot)];
+    }
+    for (const Placement& p : move) --counts[tileIndex(p.tile)];
+    for (int a = 0; a < TILE_KINDS; ++a) {
+        if (counts[a] <= 0) continue;
+        t[TermLeaveDuplicates] += counts[a] - 1;
+        for (int b = a + 1; b < TILE_KINDS; ++b) {
+            if (counts[b] > 0 && (a / 6 == b / 6 || a % 6 == b % 6)) t[TermLeaveSynergy] += 1;
+        }
+    }
+
+    // Lines through the placed tiles: the main line once, each cross line once.
+    // On a board that tracks open lines, a 5-long line with both ends blocked
+    // is no threat; otherwise every 5-long line counts.
+    auto countLine = [&](const Placement& p, int dx, int dy) {
+        int length = rules::lineThrough(board, move, p.pos.first, p.pos.second, dx, dy).length;
+        if (length == rules::MAX_LINE - 1) {
+            if (!board.tracksOpenLines() || staysOpen(board, move, p, dx == 0)) t[TermQwirkleThreat] += 1;
+        } else if (length >= 3) {
+            t[TermOpenLines] += 1;
+        }
+    };
+    const Placement& first = *move.begin();
+    bool horizontal = move.size() == 1 || move.begin()[1].pos.second == first.pos.second;
+    int dx = horizontal ? 1 : 0, dy = horizontal ? 0 : 1;
+    countLine(first, dx, dy);
+    for (const Placement& p : move) countLine(p, dy, dx);
+    return t;
+}
+
+double HeuristicBot::weigh(const std::array<double, TERM_COUNT>& t) const {
+    double value = 0;
+    for (int i = 0; i < TERM_COUNT; ++i) value += weights[i] * t[i];
+    return value;
+}
+
+double HeuristicBot::evaluate(const Board& board, const Hand& hand, const Move& move) const {
+    return weigh(terms(board, hand, move));
+}
+
+Move HeuristicBot::choose(const GameState& state) {
+    moves.clear();
+    batch.clear();
+    movegen::generateMoves(state.board, state.hand(), moves, batch);
+    scores.resize(moves.size());
+    qwirkles.resize(moves.size());
+    rules::scoreBatch(batch, scores.data(), qwirkles.data());
+
+    const Move* best = nullptr;
+    double bestValue = 0;
+    for (size_t i = 0; i < moves.size(); ++i) {
+        double value = weigh(terms(state.board, state.hand(), moves[i], scores[i]));
+        if (!best || value > bestValue) {
+            best = &moves[i];
+            bestValue = value;
+        }
+    }
+    return best ? *best : Move{};
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "GameState.h"
+#include "Move.h"
+#include "ScoreBatch.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Terms of the heuristic move evaluation, each multiplied by a weight
+enum EvalTerm {
+    TermScore,           // points the move scores
+    TermLeaveSynergy,    // pairs of kept tiles sharing a color or shape
+    TermLeaveDuplicates, // extra copies of a kind among kept tiles
+    TermQwirkleThreat,   // lines the move leaves one tile short of a Qwirkle, still completable
+    TermOpenLines,       // lines of 3-4 the move leaves for opponents to extend
+    TERM_COUNT
+};
+
+using EvalWeights = std::array<double, TERM_COUNT>;
+
+const char* termName(int term);
+EvalWeights defaultWeights();
+
+// One-ply bot: plays the legal move with the highest weighted sum of terms.
+// Cheap enough to play thousands of games per core for weight tuning. Games
+// it plays should call Board::trackLines(), so blocked lines aren't counted
+// as Qwirkle threats.
+class HeuristicBot {
+public:
+    explicit HeuristicBot(const EvalWeights& weights = defaultWeights()) : weights(weights) {}
+
+    // Empty move when there is nothing legal (a pass)
+    Move choose(const GameState& state);
+
+    std::array<double, TERM_COUNT> terms(const Board& board, const Hand& hand, const Move& move) const;
+    // Same, with the move's points already known
+    std::array<double, TERM_COUNT> terms(const Board& board, const Hand& hand, const Move& move, int score) const;
+    double evaluate(const Board& board, const Hand& hand, const Move& move) const;
+
+private:
+    double weigh(const std::array<double, TERM_COUNT>& t) const;
+
+    EvalWeights weights;
+    MoveList moves; // reused between calls
+    ScoreBatch batch;
+    std::vector<std::uint8_t> scores, qwirkles;
+};
@@ -0,0 +1,24 @@
+#include "ImageWriter.h"
+#include <algorithm>
+
+void ImageWriter::write(sf::Image image, std::string path) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [&] { return pending < limit; });
+        ++pending;
+        peak = std::max(peak, pending);
+    }
+    pool.submit([this, image = std::move(image), path = std::move(path)] {
+        if (!image.saveToFile(path)) failed.fetch_add(1);
+        // Notify under the lock: once finish() can see pending == 0 it may
+        // return and destroy us, so nothing here may touch members after
+        std::lock_guard<std::mutex> lock(mutex);
+        --pending;
+        done.notify_all();
+    });
+}
+
+void ImageWriter::finish() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return pending == 0; });
+}
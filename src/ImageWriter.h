@@ -0,0 +1,35 @@
+#pragma once
+#include "ThreadPool.h"
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+// Encodes rendered images to files on a thread pool while the caller renders
+// the next ones. At most `limit` images wait at once: write() blocks until
+// there is room, which keeps memory flat over any number of images.
+class ImageWriter {
+public:
+    ImageWriter(ThreadPool& pool, int limit) : pool(pool), limit(limit) {}
+    ~ImageWriter() { finish(); }
+    ImageWriter(const ImageWriter&) = delete;
+    ImageWriter& operator=(const ImageWriter&) = delete;
+
+    // Format from the extension, as sf::Image::saveToFile
+    void write(sf::Image image, std::string path);
+    // Waits for every queued image
+    void finish();
+
+    int peakQueued() const { return peak; }
+    int failures() const { return failed.load(); }
+
+private:
+    ThreadPool& pool;
+    int limit;
+    std::mutex mutex;
+    std::condition_variable done;
+    int pending = 0;
+    int peak = 0;
+    std::atomic<int> failed{0};
+};
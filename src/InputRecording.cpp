@@ -0,0 +1,93 @@
+#include "InputRecording.h"
+#include <iostream>
+#include <sstream>
+
+bool InputRecorder::open(const std::string& path, std::uint32_t seed) {
+    out.open(path);
+    if (!out) {
+        std::cerr << "Error: cannot write input recording '" << path << "'\n";
+        return false;
+    }
+    out << "qwirkle-input 1 " << seed << "\n";
+    return true;
+}
+
+void InputRecorder::record(std::uint32_t frame, std::int64_t micros, const sf::Event& event) {
+    switch (event.type) {
+        case sf::Event::Closed:
+            out << frame << ' ' << micros << " closed\n";
+            break;
+        case sf::Event::Resized:
+            out << frame << ' ' << micros << " resized " << event.size.width << ' ' << event.size.height << "\n";
+            break;
+        case sf::Event::MouseButtonPressed:
+        case sf::Event::MouseButtonReleased:
+            out << frame << ' ' << micros << (event.type == sf::Event::MouseButtonPressed ? " press " : " release ")
+                << static_cast<int>(event.mouseButton.button) << ' ' << event.mouseButton.x << ' ' << event.mouseButton.y << "\n";
+            break;
+        case sf::Event::MouseMoved:
+            out << frame << ' ' << micros << " move " << event.mouseMove.x << ' ' << event.mouseMove.y << "\n";
+            break;
+        case sf::Event::KeyPressed:
+        case sf::Event::KeyReleased:
+            out << frame << ' ' << micros << (event.type == sf::Event::KeyPressed ? " keydown " : " keyup ")
+                << static_cast<int>(event.key.code) << "\n";
+            break;
+        default:
+            break; // not used by the game
+    }
+}
+
+bool InputPlayback::load(const std::string& path) {
+    std::ifstream in(path);
+    std::string magic;
+    int version = 0;
+    if (!(in >> magic >> version >> seed) || magic != "qwirkle-input" || version != 1) {
+        std::cerr << "Error: '" << path << "' is not an input recording\n";
+        return false;
+    }
+
+    std::string line;
+    std::getline(in, line);
+    while (std::getline(in, line)) {
+        std::istringstream fields(line);
+        Entry e{};
+        std::int64_t micros;
+        std::string type;
+        if (!(fields >> e.frame >> micros >> type)) continue;
+
+        sf::Event& ev = e.event;
+        if (type == "closed") {
+            ev.type = sf::Event::Closed;
+        } else if (type == "resized") {
+            ev.type = sf::Event::Resized;
+            fields >> ev.size.width >> ev.size.height;
+        } else if (type == "press" || type == "release") {
+            int button;
+            ev.type = type == "press" ? sf::Event::MouseButtonPressed : sf::Event::MouseButtonReleased;
+            fields >> button >> ev.mouseButton.x >> ev.mouseButton.y;
+            ev.mouseButton.button = static_cast<sf::Mouse::Button>(button);
+        } else if (type == "move") {
+            ev.type = sf::Event::MouseMoved;
+            fields >> ev.mouseMove.x >> ev.mouseMove.y;
+        } else if (type == "keydown" || type == "keyup") {
+            int code;
+            ev.type = type == "keydown" ? sf::Event::KeyPressed : sf::Event::KeyReleased;
+            fields >> code;
+            ev.key.code = static_cast<sf::Keyboard::Key>(code);
+        } else {
+            continue;
+        }
+        if (fields.fail()) continue;
+        events.push_back(e);
+    }
+    loaded = true;
+    return true;
+}
+
+void InputPlayback::eventsForFrame(std::uint32_t frame, std::vector<sf::Event>& out) {
+    while (next < events.size() && events[next].frame <= frame) {
+        out.push_back(events[next].event);
+        ++next;
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <SFML/Window.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Records the window's input events with the frame they arrived on, so a
+// session can be replayed deterministically (events are re-injected on the
+// same frame index, regardless of how long frames take during playback).
+// Text format, after a "qwirkle-input 1 <seed>" header line:
+//     <frame> <micros> <type> <args...>
+class InputRecorder {
+public:
+    bool open(const std::string& path, std::uint32_t seed);
+    bool isOpen() const { return out.is_open(); }
+    void record(std::uint32_t frame, std::int64_t micros, const sf::Event& event);
+
+private:
+    std::ofstream out;
+};
+
+class InputPlayback {
+public:
+    bool load(const std::string& path);
+    bool isLoaded() const { return loaded; }
+    std::uint32_t getSeed() const { return seed; }
+
+    // Append the events recorded for `frame`; frames must be asked in order
+    void eventsForFrame(std::uint32_t frame, std::vector<sf::Event>& out);
+    bool finished() const { return next >= events.size(); }
+
+private:
+    struct Entry {
+        std::uint32_t frame;
+        sf::Event event;
+    };
+
+    std::vector<Entry> events;
+    size_t next = 0;
+    std::uint32_t seed = 0;
+    bool loaded = false;
+};
@@ -0,0 +1,256 @@
+#include "Journal.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#define QWIRKLE_OPEN ::_open
+#define QWIRKLE_WRITE ::_write
+#define QWIRKLE_CLOSE ::_close
+#define QWIRKLE_FSYNC ::_commit
+#define O_FLAGS_APPEND (_O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY)
+#define O_FLAGS_TRUNC (_O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY)
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#define QWIRKLE_OPEN ::open
+#define QWIRKLE_WRITE ::write
+#define QWIRKLE_CLOSE ::close
+#define QWIRKLE_FSYNC ::fsync
+#define O_FLAGS_APPEND (O_WRONLY | O_CREAT | O_APPEND)
+#define O_FLAGS_TRUNC (O_WRONLY | O_CREAT | O_TRUNC)
+#endif
+
+namespace {
+
+bool writeAll(int fd, const std::string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        auto n = QWIRKLE_WRITE(fd, data.data() + done, static_cast<unsigned>(data.size() - done));
+        if (n <= 0) return false;
+        done += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// FNV-1a over a journal line's "<seq> <action>", so a line cut short by a
+// crash is told apart from a complete one
+std::uint32_t lineChecksum(const std::string& text) {
+    std::uint32_t h = 2166136261u;
+    for (unsigned char c : text) {
+        h ^= c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+std::string journalLine(std::uint64_t seq, const std::string& action) {
+    std::string text = std::to_string(seq) + ' ' + action;
+    char sum[16];
+    std::snprintf(sum, sizeof(sum), "\t%08x\n", static_cast<unsigned>(lineChecksum(text)));
+    return text + sum;
+}
+
+// Makes a rename in `directory` durable
+bool syncDirectory(const std::string& directory) {
+#if defined(_WIN32)
+    (void)directory; // NTFS journals the rename itself
+    return true;
+#else
+    int dir = ::open(directory.c_str(), O_RDONLY);
+    if (dir < 0) return false;
+    bool ok = ::fsync(dir) == 0;
+    ::close(dir);
+    return ok;
+#endif
+}
+
+} // namespace
+
+Journal::Journal(std::string directory) : directory(std::move(directory)) {}
+
+Journal::~Journal() {
+    if (io.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        io.join();
+    }
+    if (fd >= 0) QWIRKLE_CLOSE(fd);
+}
+
+// Snapshot file: "qwirkle-snapshot <last seq>\n" then the state text.
+// Journal lines: "<seq> <action>\t<checksum>", checksum as 8 hex digits.
+bool Journal::restore(std::string& snapshot, std::vector<std::string>& actions) {
+    snapshot.clear();
+    actions.clear();
+    std::uint64_t covered = 0;
+
+    std::ifstream snap(snapshotPath());
+    std::string magic;
+    if (snap >> magic >> covered && magic == "qwirkle-snapshot") {
+        snap.get(); // newline after the header
+        std::ostringstream rest;
+        rest << snap.rdbuf();
+        snapshot = rest.str();
+    } else {
+        covered = 0;
+    }
+
+    std::ifstream log(journalPath(), std::ios::binary);
+    std::string line;
+    std::uint64_t last = covered;
+    validBytes = 0;
+    while (std::getline(log, line)) {
+        // Replay stops at the first line that doesn't check out: a torn
+        // final write, whatever part of it reached the disk. start() cuts
+        // the journal back to the last good line before appending.
+        if (log.eof()) break; // no newline: the write never finished
+        size_t tab = line.rfind('\t');
+        if (tab == std::string::npos || line.size() - tab != 9) break;
+        char* end = nullptr;
+        unsigned long sum = std::strtoul(line.c_str() + tab + 1, &end, 16);
+        if (*end != '\0' || sum != lineChecksum(line.substr(0, tab))) break;
+        line.resize(tab);
+
+        std::istringstream fields(line);
+        std::uint64_t seq;
+        if (!(fields >> seq)) break;
+        validBytes = static_cast<std::uintmax_t>(log.tellg());
+        if (seq <= covered) continue;
+        std::string action;
+        std::getline(fields >> std::ws, action);
+        actions.push_back(action);
+        last = seq;
+    }
+    nextSeq = last + 1;
+    return !snapshot.empty() || !actions.empty();
+}
+
+void Journal::discard() {
+    std::error_code ec;
+    std::filesystem::remove(journalPath(), ec);
+    std::filesystem::remove(snapshotPath(), ec);
+    nextSeq = 1;
+    validBytes = 0;
+}
+
+bool Journal::start() {
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    // Drop a torn tail left by a crash, or new lines would follow it and be
+    // lost with it on the next restore
+    if (validBytes != KEEP_ALL && std::filesystem::exists(journalPath(), ec)
+        && std::filesystem::file_size(journalPath(), ec) > validBytes) {
+        std::filesystem::resize_file(journalPath(), validBytes, ec);
+        if (ec) {
+            std::cerr << "Warning: autosave disabled, cannot repair '" << journalPath() << "'\n";
+            return false;
+        }
+    }
+    openJournal(false);
+    if (fd < 0) {
+        std::cerr << "Warning: autosave disabled, cannot open '" << journalPath() << "'\n";
+        return false;
+    }
+    io = std::thread(&Journal::ioLoop, this);
+    return true;
+}
+
+void Journal::append(const std::string& action) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back({false, nextSeq++, action});
+    }
+    ++sinceSnapshot;
+    wake.notify_one();
+}
+
+void Journal::snapshot(const std::string& state) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back({true, nextSeq - 1, state});
+    }
+    sinceSnapshot = 0;
+    wake.notify_one();
+}
+
+void Journal::openJournal(bool truncate) {
+    if (fd >= 0) QWIRKLE_CLOSE(fd);
+    fd = QWIRKLE_OPEN(journalPath().c_str(), truncate ? O_FLAGS_TRUNC : O_FLAGS_APPEND, 0644);
+}
+
+void Journal::syncJournal() {
+    if (fd >= 0) QWIRKLE_FSYNC(fd);
+}
+
+bool Journal::writeSnapshot(const Record& r) {
+    std::string tmp = snapshotPath() + ".tmp";
+    int out = QWIRKLE_OPEN(tmp.c_str(), O_FLAGS_TRUNC, 0644);
+    if (out < 0) return false;
+    bool ok = writeAll(out, "qwirkle-snapshot " + std::to_string(r.seq) + "\n") && writeAll(out, r.data);
+    ok = ok && QWIRKLE_FSYNC(out) == 0;
+    QWIRKLE_CLOSE(out);
+    if (!ok) return false;
+
+    std::error_code ec;
+    std::filesystem::rename(tmp, snapshotPath(), ec);
+    // The rename must be on disk before the journal is truncated, or a crash
+    // could leave the old snapshot next to an empty journal
+    return !ec && syncDirectory(directory);
+}
+
+void Journal::ioLoop() {
+    std::vector<Record> batch;
+    auto lastSync = std::chrono::steady_clock::now();
+    bool dirty = false;
+
+    for (;;) {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait_for(lock, std::chrono::milliseconds(FSYNC_INTERVAL_MS),
+                          [&] { return stopping || !queue.empty(); });
+            batch.swap(queue);
+            stop = stopping;
+        }
+
+        std::string lines;
+        for (const Record& r : batch) {
+            if (!r.isSnapshot) {
+                lines += journalLine(r.seq, r.data);
+                continue;
+            }
+            // Entries before the snapshot go to the old journal first, so a
+            // failed snapshot loses nothing
+            if (!lines.empty() && fd >= 0) writeAll(fd, lines);
+            lines.clear();
+            syncJournal();
+            if (writeSnapshot(r)) openJournal(true);
+            dirty = false;
+            lastSync = std::chrono::steady_clock::now();
+        }
+        batch.clear();
+
+        if (!lines.empty() && fd >= 0) {
+            writeAll(fd, lines);
+            dirty = true;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (dirty && (stop || now - lastSync >= std::chrono::milliseconds(FSYNC_INTERVAL_MS))) {
+            syncJournal();
+            dirty = false;
+            lastSync = now;
+        }
+        if (stop) break;
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Crash-safe autosave: an append-only journal of actions plus periodic
+// compacted snapshots, all written by a background I/O thread.
+//
+// append() and snapshot() only copy the data into a queue under a short
+// lock, so the render loop never waits on disk. The I/O thread writes queued
+// records in order and fsyncs in batches (at most every FSYNC_INTERVAL_MS).
+// A snapshot is written to a temporary file, synced and renamed into place
+// and its directory synced, then the journal is truncated. Records carry
+// sequence numbers and the snapshot remembers the last one it covers, so a
+// crash between the rename and the truncation never replays an action
+// twice. Each journal line ends in a checksum; replay stops at the first
+// line that fails it, and start() cuts that line off before appending.
+class Journal {
+public:
+    static constexpr int FSYNC_INTERVAL_MS = 100;
+
+    explicit Journal(std::string directory);
+    ~Journal(); // flushes, syncs and joins the I/O thread
+    Journal(const Journal&) = delete;
+    Journal& operator=(const Journal&) = delete;
+
+    // Previous session: the last snapshot and the actions logged after it.
+    // Returns false when there is nothing to restore.
+    bool restore(std::string& snapshot, std::vector<std::string>& actions);
+
+    // Remove any saved session (start fresh)
+    void discard();
+
+    // Start the I/O thread; continues sequence numbers after restore()
+    bool start();
+
+    void append(const std::string& action);
+    void snapshot(const std::string& state);
+
+    // Records appended since the last snapshot
+    int pendingSinceSnapshot() const { return sinceSnapshot; }
+
+private:
+    struct Record {
+        bool isSnapshot;
+        std::uint64_t seq; // for snapshots: last action covered
+        std::string data;
+    };
+
+    void ioLoop();
+    bool writeSnapshot(const Record& r);
+    void openJournal(bool truncate);
+    void syncJournal();
+
+    std::string journalPath() const { return directory + "/journal.log"; }
+    std::string snapshotPath() const { return directory + "/snapshot.txt"; }
+
+    static constexpr std::uintmax_t KEEP_ALL = ~std::uintmax_t{0};
+
+    std::string directory;
+    int fd = -1;
+    std::uintmax_t validBytes = KEEP_ALL; // journal length up to its last good line
+    std::uint64_t nextSeq = 1;
+    int sinceSnapshot = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::vector<Record> queue;
+    bool stopping = false;
+    std::thread io;
+};
@@ -0,0 +1,193 @@
+#include "JsonReader.h"
+#include <cstring>
+
+void JsonReader::skipSpace() {
+    while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t')) ++p;
+}
+
+bool JsonReader::expect(char c) {
+    if (failed) return false;
+    skipSpace();
+    if (p == end || *p != c) return fail();
+    ++p;
+    first = true;
+    return true;
+}
+
+bool JsonReader::nextKey(std::string_view& key) {
+    if (failed) return false;
+    skipSpace();
+    if (p < end && *p == '}') {
+        ++p;
+        first = false;
+        return false;
+    }
+    if (!first) {
+        if (p == end || *p != ',') return fail();
+        ++p;
+    }
+    first = false;
+    if (!readString(key)) return false;
+    skipSpace();
+    if (p == end || *p != ':') return fail();
+    ++p;
+    return true;
+}
+
+bool JsonReader::nextElement() {
+    if (failed) return false;
+    skipSpace();
+    if (p < end && *p == ']') {
+        ++p;
+        first = false;
+        return false;
+    }
+    if (!first) {
+        if (p == end || *p != ',') return fail();
+        ++p;
+    }
+    first = false;
+    return true;
+}
+
+bool JsonReader::readInt(std::int64_t& value) {
+    if (failed) return false;
+    skipSpace();
+    bool negative = p < end && *p == '-';
+    if (negative) ++p;
+    if (p == end || *p < '0' || *p > '9') return fail();
+    // Accumulate unsigned so a long digit run can be rejected, not overflow
+    const std::uint64_t limit = negative ? std::uint64_t{1} << 63 : (std::uint64_t{1} << 63) - 1;
+    std::uint64_t v = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        unsigned digit = static_cast<unsigned>(*p++ - '0');
+        if (v > (limit - digit) / 10) return fail();
+        v = v * 10 + digit;
+    }
+    value = negative ? static_cast<std::int64_t>(0 - v) : static_cast<std::int64_t>(v);
+    first = false;
+    return true;
+}
+
+bool JsonReader::readBool(bool& value) {
+    if (failed) return false;
+    skipSpace();
+    if (end - p >= 4 && std::memcmp(p, "true", 4) == 0) {
+        p += 4;
+        value = true;
+    } else if (end - p >= 5 && std::memcmp(p, "false", 5) == 0) {
+        p += 5;
+        value = false;
+    } else {
+        return fail();
+    }
+    first = false;
+    return true;
+}
+
+bool JsonReader::readNull() {
+    if (failed) return false;
+    skipSpace();
+    if (end - p >= 4 && std::memcmp(p, "null", 4) == 0) {
+        p += 4;
+        first = false;
+        return true;
+    }
+    return false;
+}
+
+bool JsonReader::readString(std::string_view& value) {
+    if (failed) return false;
+    skipSpace();
+    if (p == end || *p != '"') return fail();
+    const char* start = ++p;
+    while (p < end && *p != '"' && *p != '\\') ++p;
+    if (p < end && *p == '"') {
+        value = std::string_view(start, static_cast<size_t>(p - start));
+        ++p;
+        first = false;
+        return true;
+    }
+
+    // Slow path: unescape into the reader's buffer
+    unescaped.assign(start, p);
+    while (p < end && *p != '"') {
+        char c = *p++;
+        if (c != '\\') {
+            unescaped += c;
+            continue;
+        }
+        if (p == end) return fail();
+        char e = *p++;
+        switch (e) {
+            case 'n': unescaped += '\n'; break;
+            case 't': unescaped += '\t'; break;
+            case 'r': unescaped += '\r'; break;
+            case 'b': unescaped += '\b'; break;
+            case 'f': unescaped += '\f'; break;
+            case 'u': {
+                // Only the ASCII range is needed by our formats
+                if (end - p < 4) return fail();
+                unsigned code = 0;
+                for (int i = 0; i < 4; ++i) {
+                    char h = *p++;
+                    code <<= 4;
+                    if (h >= '0' && h <= '9') code |= static_cast<unsigned>(h - '0');
+                    else if (h >= 'a' && h <= 'f') code |= static_cast<unsigned>(h - 'a' + 10);
+                    else if (h >= 'A' && h <= 'F') code |= static_cast<unsigned>(h - 'A' + 10);
+                    else return fail();
+                }
+                if (code > 0x7F) return fail();
+                unescaped += static_cast<char>(code);
+                break;
+            }
+            default: unescaped += e; break; // \" \\ \/
+        }
+    }
+    if (p == end) return fail();
+    ++p;
+    value = unescaped;
+    first = false;
+    return true;
+}
+
+bool JsonReader::skipValue() {
+    if (failed) return false;
+    skipSpace();
+    if (p == end) return fail();
+    std::string_view s;
+    std::int64_t i;
+    bool b;
+    switch (*p) {
+        case '{':
+            if (!beginObject()) return false;
+            while (nextKey(s)) {
+                if (!skipValue()) return false;
+            }
+            return ok();
+        case '[':
+            if (!beginArray()) return false;
+            while (nextElement()) {
+                if (!skipValue()) return false;
+            }
+            return ok();
+        case '"':
+            return readString(s);
+        case 't':
+        case 'f':
+            return readBool(b);
+        case 'n':
+            return readNull() || fail();
+        default:
+            if (!readInt(i)) return false;
+            // fractions / exponents are not used by our formats but must be skippable
+            while (p < end && (*p == '.' || *p == 'e' || *p == 'E' || *p == '+' || *p == '-'
+                               || (*p >= '0' && *p <= '9'))) ++p;
+            return true;
+    }
+}
+
+bool JsonReader::atEnd() {
+    skipSpace();
+    return p == end;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Streaming (pull) JSON reader over an in-memory buffer.
+// The caller walks the document in the order it expects it, e.g.
+//     if (!r.beginObject()) return false;
+//     std::string_view key;
+//     while (r.nextKey(key)) { if (key == "x") r.readInt(x); else r.skipValue(); }
+// No tree is built and strings without escapes are returned as views into
+// the buffer. Any syntax error makes every later call fail (see ok()).
+class JsonReader {
+public:
+    JsonReader(const char* data, size_t size) : p(data), end(data + size) {}
+    explicit JsonReader(std::string_view text) : JsonReader(text.data(), text.size()) {}
+
+    bool beginObject() { return expect('{'); }
+    // Next key of the current object; false (and consumes '}') at its end
+    bool nextKey(std::string_view& key);
+
+    bool beginArray() { return expect('['); }
+    // True if another element follows; false (and consumes ']') at the end
+    bool nextElement();
+
+    bool readInt(std::int64_t& value); // fails outside the int64 range
+    bool readBool(bool& value);
+    bool readNull(); // consumes a null literal if present
+    bool readString(std::string_view& value);
+    bool skipValue();
+
+    bool ok() const { return !failed; }
+    bool atEnd(); // only whitespace remains
+
+private:
+    void skipSpace();
+    bool expect(char c);
+    bool fail() {
+        failed = true;
+        return false;
+    }
+
+    const char* p;
+    const char* end;
+    bool failed = false;
+    bool first = true; // no element/key read yet in the current container
+    std::string unescaped; // backing store for strings with escapes
+};
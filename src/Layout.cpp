@@ -0,0 +1,66 @@
+#include "Layout.h"
+#include <algorithm>
+#include <cmath>
+
+bool Layout::update(sf::Vector2u size) {
+    if (size.x == windowSize.x && size.y == windowSize.y) return false;
+    windowSize = size;
+    const float w = static_cast<float>(size.x), h = static_cast<float>(size.y);
+    const Metrics& m = metrics;
+
+    // Hand: six slots centered along the bottom
+    float slotW = m.tileSize + m.slotPadding;
+    float handX = (w - (slotW * 6 - m.slotPadding)) / 2;
+    float handY = h - m.tileSize - m.margin;
+    for (int i = 0; i < 6; ++i) rects[HAND_SLOT + i] = sf::FloatRect(handX + i * slotW, handY, m.tileSize, m.tileSize);
+    rects[HAND_BAND] = sf::FloatRect(0, handY, w, m.tileSize);
+
+    // Buttons along the bottom left
+    float buttonY = h - m.buttonHeight - m.margin;
+    rects[CONFIRM] = sf::FloatRect(m.margin, buttonY, m.buttonWidth, m.buttonHeight);
+    rects[EXIT] = sf::FloatRect(2 * m.margin + m.buttonWidth, buttonY, m.buttonWidth, m.buttonHeight);
+    rects[RESET] = sf::FloatRect(3 * m.margin + 2 * m.buttonWidth, buttonY, m.buttonWidth, m.buttonHeight);
+
+    rects[BAG_COUNT] = sf::FloatRect(w - m.margin, buttonY, 0, 0);
+
+    buildGrid();
+    return true;
+}
+
+void Layout::buildGrid() {
+    gridW = std::max(1, static_cast<int>(std::ceil(windowSize.x / GRID_CELL)));
+    gridH = std::max(1, static_cast<int>(std::ceil(windowSize.y / GRID_CELL)));
+    std::vector<std::vector<std::uint8_t>> cells(static_cast<size_t>(gridW) * gridH);
+    for (int r = 0; r < REGION_COUNT; ++r) {
+        const sf::FloatRect& box = rects[r];
+        if (box.width <= 0 || box.height <= 0) continue; // anchors only
+        int x0 = std::clamp(static_cast<int>(box.left / GRID_CELL), 0, gridW - 1);
+        int x1 = std::clamp(static_cast<int>((box.left + box.width) / GRID_CELL), 0, gridW - 1);
+        int y0 = std::clamp(static_cast<int>(box.top / GRID_CELL), 0, gridH - 1);
+        int y1 = std::clamp(static_cast<int>((box.top + box.height) / GRID_CELL), 0, gridH - 1);
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) cells[static_cast<size_t>(y) * gridW + x].push_back(static_cast<std::uint8_t>(r));
+        }
+    }
+    start.assign(1, 0);
+    items.clear();
+    for (const auto& c : cells) {
+        items.insert(items.end(), c.begin(), c.end()); // in region order, so priority holds
+        start.push_back(static_cast<std::uint32_t>(items.size()));
+    }
+}
+
+int Layout::hit(sf::Vector2f p) const {
+    if (p.x < 0 || p.y < 0 || gridW == 0) return -1;
+    int x = static_cast<int>(p.x / GRID_CELL), y = static_cast<int>(p.y / GRID_CELL);
+    if (x >= gridW || y >= gridH) return -1;
+    size_t c = static_cast<size_t>(y) * gridW + x;
+    for (std::uint32_t i = start[c]; i < start[c + 1]; ++i) {
+        // Edges inclusive, as the hand's hit-testing always was
+        const sf::FloatRect& box = rects[items[i]];
+        if (p.x >= box.left && p.x <= box.left + box.width && p.y >= box.top && p.y <= box.top + box.height) {
+            return items[i];
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Screen rectangles of the game's UI for one window size. They are worked
+// out once per resize and cached, so drawing and hit-testing read the same
+// geometry. A coarse grid over the window lists the regions touching each
+// cell, which makes hit() a constant-time lookup.
+class Layout {
+public:
+    // Regions in hit-test priority: where two overlap, the earlier one wins
+    enum Region {
+        CONFIRM,
+        EXIT,
+        RESET,
+        HAND_SLOT,                     // six of them, HAND_SLOT + i
+        HAND_BAND = HAND_SLOT + 6,     // the strip the hand sits in; swallows clicks between slots
+        BAG_COUNT,                     // anchor: top-right corner of the tiles-left text
+        REGION_COUNT
+    };
+
+    // Sizes in pixels; the defaults match the original fixed UI
+    struct Metrics {
+        float tileSize = 64;
+        float slotPadding = 6;
+        float buttonWidth = 90;
+        float buttonHeight = 40;
+        float margin = 10;
+    };
+
+    explicit Layout(const Metrics& metrics) : metrics(metrics) {}
+
+    // Recomputes everything if the size changed; true if it did
+    bool update(sf::Vector2u windowSize);
+    sf::Vector2u size() const { return windowSize; }
+
+    const sf::FloatRect& rect(int region) const { return rects[region]; }
+    // Region under a screen point, -1 for none (the board)
+    int hit(sf::Vector2f screenPos) const;
+
+private:
+    static constexpr float GRID_CELL = 64; // pixels per hit-test grid cell
+
+    void buildGrid();
+
+    Metrics metrics;
+    sf::Vector2u windowSize{0, 0};
+    std::array<sf::FloatRect, REGION_COUNT> rects;
+
+    // Regions per grid cell, flattened: cell c lists items[start[c]..start[c + 1])
+    int gridW = 0, gridH = 0;
+    std::vector<std::uint32_t> start;
+    std::vector<std::uint8_t> items;
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include "Board.h"
+#include <array>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+struct Placement {
+    Coord pos;
+    Tile tile;
+};
+
+// One turn's placements; at most a full hand of six tiles.
+// Fixed capacity so move lists are a single flat allocation.
+struct Move {
+    static constexpr int MAX_TILES = 6;
+
+    std::array<Placement, MAX_TILES> placements;
+    std::uint8_t count = 0;
+
+    void add(const Placement& p) { placements[count++] = p; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+    const Placement* begin() const { return placements.data(); }
+    const Placement* end() const { return placements.data() + count; }
+};
+
+using MoveList = std::pmr::vector<Move>;
@@ -0,0 +1,197 @@
+#include "MoveGen.h"
+#include "Rules.h"
+#include <algorithm>
+#include <set>
+
+namespace movegen {
+
+namespace {
+
+struct Generator {
+    Generator(const Board& board, MoveList& out, ScoreBatch* batch) : board(board), out(out), batch(batch) {}
+
+    const Board& board;
+    MoveList& out;
+    ScoreBatch* batch;
+    int counts[TILE_KINDS] = {};
+    int dx = 1, dy = 0; // main axis
+    Move move;
+    std::uint8_t crossLengths[Move::MAX_TILES] = {}; // per placement of `move`
+
+    // Board tiles perpendicular to the main axis through (x, y), plus `t`
+    rules::LineMasks crossLine(int x, int y, const Tile& t) const {
+        rules::LineMasks line;
+        rules::addToLine(line, t);
+        int px = dy, py = dx; // perpendicular step
+        if (const Segment* s = board.segmentAt(x - px, y - py, dx == 1)) rules::addToLine(line, *s);
+        if (const Segment* s = board.segmentAt(x + px, y + py, dx == 1)) rules::addToLine(line, *s);
+        return line;
+    }
+
+    // Place tiles from (x, y) onward; `main` holds the run behind (x, y),
+    // `touches` whether anything so far connects to the board
+    void extend(int x, int y, rules::LineMasks main, bool touches) {
+        // Existing tiles in the way become part of the main line; (x, y)
+        // follows an empty cell, so it is where their segment starts
+        if (const Segment* s = board.segmentAt(x, y, dy == 1)) {
+            rules::addToLine(main, *s);
+            touches = true;
+            x += s->length * dx;
+            y += s->length * dy;
+        }
+        if (!move.empty()) {
+            // `main` already includes any tiles right after the last placement
+            if (rules::isValidLine(main) && (touches || board.empty())
+                && (move.count > 1 || dx == 1)) {
+                out.push_back(move);
+                if (batch) batch->push(move, dy == 1, main.length, crossLengths);
+            }
+        }
+        if (move.count == Move::MAX_TILES || main.length >= rules::MAX_LINE) return;
+
+        for (int k = 0; k < TILE_KINDS; ++k) {
+            if (!counts[k]) continue;
+            Tile t = tileFromIndex(k);
+            rules::LineMasks next = main;
+            rules::addToLine(next, t);
+            if (!rules::isValidLine(next)) continue; // lines only get worse as they grow
+            rules::LineMasks cross = crossLine(x, y, t);
+            if (!rules::isValidLine(cross)) continue;
+
+            --counts[k];
+            crossLengths[move.count] = static_cast<std::uint8_t>(cross.length);
+            move.add({{x, y}, t});
+            extend(x + dx, y + dy, next, touches || cross.length > 1);
+            --move.count;
+            ++counts[k];
+        }
+    }
+
+    void fromStart(int x, int y) {
+        // Existing run immediately behind the start cell
+        rules::LineMasks behind;
+        const Segment* s = board.segmentAt(x - dx, y - dy, dy == 1);
+        if (s) rules::addToLine(behind, *s);
+        extend(x, y, behind, s != nullptr);
+    }
+};
+
+} // namespace
+
+void generateMoves(const Board& board, const Hand& hand, MoveList& out) {
+    generateMoves(board, hand, out, nullptr);
+}
+
+void generateMoves(const Board& board, const Hand& hand, MoveList& out, ScoreBatch& batch) {
+    generateMoves(board, hand, out, nullptr, &batch);
+}
+
+bool generateMoves(const Board& board, const Hand& hand, MoveList& out, const std::function<bool()>& stop,
+                   ScoreBatch* batch) {
+    Generator gen(board, out, batch);
+    for (const auto& slot : hand) {
+        if (slot) ++gen.counts[tileIndex(*slot)];
+    }
+
+    for (int axis = 0; axis < 2; ++axis) {
+        gen.dx = axis == 0 ? 1 : 0;
+        gen.dy = axis == 0 ? 0 : 1;
+        if (board.empty()) {
+            gen.fromStart(0, 0);
+            continue;
+        }
+        // A move's first tile lies at most five empty cells before a frontier
+        // cell on its axis; collect each candidate start once
+        CoordSet starts(out.get_allocator().resource());
+        for (const Coord& f : board.getFrontier()) {
+            for (int k = 0, x = f.first, y = f.second; k < Move::MAX_TILES; ++k, x -= gen.dx, y -= gen.dy) {
+                if (board.isOccupied(x, y)) break;
+                starts.insert({x, y});
+            }
+        }
+        for (const Coord& s : starts) {
+            if (stop && stop()) return false;
+            gen.fromStart(s.first, s.second);
+        }
+    }
+    return true;
+}
+
+std::vector<std::tuple<int, int, int>> canonicalKey(const Move& move) {
+    std::vector<std::tuple<int, int, int>> key;
+    for (const Placement& p : move) key.emplace_back(p.pos.first, p.pos.second, tileIndex(p.tile));
+    std::sort(key.begin(), key.end());
+    return key;
+}
+
+void generateMovesReference(const Board& board, const Hand& hand, MoveList& out) {
+    std::vector<Tile> tiles;
+    for (const auto& slot : hand) {
+        if (slot) tiles.push_back(*slot);
+    }
+
+    // Any legal move lies within MAX_TILES cells of the existing tiles
+    int minX = 0, maxX = 0, minY = 0, maxY = 0;
+    bool first = true;
+    for (const auto& t : board.getTiles()) {
+        minX = first ? t.first.first : std::min(minX, t.first.first);
+        maxX = first ? t.first.first : std::max(maxX, t.first.first);
+        minY = first ? t.first.second : std::min(minY, t.first.second);
+        maxY = first ? t.first.second : std::max(maxY, t.first.second);
+        first = false;
+    }
+    if (board.empty()) {
+        // Opening moves are canonicalised to start at (0, 0)
+        maxX = minX = maxY = minY = 0;
+    } else {
+        minX -= Move::MAX_TILES;
+        maxX += Move::MAX_TILES;
+        minY -= Move::MAX_TILES;
+        maxY += Move::MAX_TILES;
+    }
+
+    std::set<std::vector<std::tuple<int, int, int>>> found;
+    std::vector<Coord> cells;
+    std::vector<int> order;
+    for (int sx = minX; sx <= maxX; ++sx) {
+        for (int sy = minY; sy <= maxY; ++sy) {
+            if (board.isOccupied(sx, sy)) continue;
+            for (int axis = 0; axis < 2; ++axis) {
+                int dx = axis == 0 ? 1 : 0, dy = 1 - dx;
+                // The first k empty cells along the axis from the start
+                cells.clear();
+                for (int x = sx, y = sy; static_cast<int>(cells.size()) < static_cast<int>(tiles.size()); x += dx, y += dy) {
+                    if (!board.isOccupied(x, y)) cells.push_back({x, y});
+                }
+                for (int k = 1; k <= static_cast<int>(cells.size()); ++k) {
+                    // Cheap necessary condition: some cell must touch the board
+                    bool touches = board.empty();
+                    for (int i = 0; i < k && !touches; ++i) {
+                        int x = cells[i].first, y = cells[i].second;
+                        touches = board.isOccupied(x + 1, y) || board.isOccupied(x - 1, y)
+                               || board.isOccupied(x, y + 1) || board.isOccupied(x, y - 1);
+                    }
+                    if (!touches) continue;
+                    // Every ordered choice of k hand tiles for those cells
+                    order.resize(tiles.size());
+                    for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int>(i);
+                    do {
+                        Move m;
+                        for (int i = 0; i < k; ++i) m.add({cells[i], tiles[order[i]]});
+                        if (rules::validateMove(board, m)) found.insert(canonicalKey(m));
+                        // skip permutations that only reorder the unused tail
+                        std::reverse(order.begin() + k, order.end());
+                    } while (std::next_permutation(order.begin(), order.end()));
+                }
+            }
+        }
+    }
+
+    for (const auto& key : found) {
+        Move m;
+        for (const auto& p : key) m.add({{std::get<0>(p), std::get<1>(p)}, tileFromIndex(std::get<2>(p))});
+        out.push_back(m);
+    }
+}
+
+} // namespace movegen
@@ -0,0 +1,42 @@
+#pragma once
+#include "Board.h"
+#include "GameState.h"
+#include "Move.h"
+#include "ScoreBatch.h"
+#include <functional>
+#include <tuple>
+#include <vector>
+
+// Legal move generation.
+//
+// Each move is produced exactly once: from its first placement (lowest
+// coordinate along its axis), walking forward along the row or column and
+// stepping over existing tiles. Single-tile moves are only produced on the
+// row pass. Duplicate tiles in the hand are collapsed, so moves are distinct
+// as placement sets. On an empty board moves start at (0, 0) and extend
+// right or down, which canonicalises away translations of the opening.
+namespace movegen {
+
+// Appends all legal placement moves (not passes) to `out`
+void generateMoves(const Board& board, const Hand& hand, MoveList& out);
+
+// Same, polling `stop` before each start cell so a timed search can abandon
+// a slow generation; returns false, with `out` partial, when it did. With a
+// `batch`, each move's line lengths are appended to it in step with `out`.
+bool generateMoves(const Board& board, const Hand& hand, MoveList& out, const std::function<bool()>& stop,
+                   ScoreBatch* batch = nullptr);
+
+// Appends the moves to `out` and their line lengths to `batch`, for scoring
+// them all at once with rules::scoreBatch()
+void generateMoves(const Board& board, const Hand& hand, MoveList& out, ScoreBatch& batch);
+
+// Slow, obviously-correct generator for cross-checking generateMoves():
+// tries every ordering of every subset of the hand on every straight run of
+// empty cells near the board and keeps what rules::validateMove() accepts.
+// Produces the same canonical set of moves, sorted by canonicalKey().
+void generateMovesReference(const Board& board, const Hand& hand, MoveList& out);
+
+// Order-independent description of a move: its placements sorted by cell
+std::vector<std::tuple<int, int, int>> canonicalKey(const Move& move);
+
+} // namespace movegen
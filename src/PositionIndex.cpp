@@ -0,0 +1,431 @@
+#include "PositionIndex.h"
+#include "ThreadPool.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <bitset>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define QWIRKLE_SSE2 1
+#endif
+
+namespace {
+
+// Feature layout
+constexpr int PAIR_SLOTS = TILE_KINDS * 10; // kinds sharing a color or a shape, per direction
+constexpr int PAIR_BASE = 0;                // horizontal pairs, then vertical
+constexpr int PRESENT_BASE = PAIR_BASE + 2 * PAIR_SLOTS;
+constexpr int HAND_BASE = PRESENT_BASE + TILE_KINDS; // kind * 3 + (copies - 1)
+constexpr int MARGIN_BASE = HAND_BASE + TILE_KINDS * 3;
+constexpr int MARGIN_THRESHOLDS[] = { -50, -30, -20, -10, -5, 0, 5, 10, 20, 30, 50 };
+constexpr int MARGIN_COUNT = sizeof(MARGIN_THRESHOLDS) / sizeof(MARGIN_THRESHOLDS[0]);
+constexpr int FEATURE_COUNT = MARGIN_BASE + MARGIN_COUNT;
+
+constexpr size_t BLOCK_WORDS = 64; // 4096 positions per evaluation block, fits in L1
+constexpr std::uint32_t INDEX_VERSION = 1;
+
+// Slot of an ordered pair of kinds that may sit side by side, or -1
+struct PairSlots {
+    int slot[TILE_KINDS][TILE_KINDS];
+    PairSlots() {
+        int next = 0;
+        for (int a = 0; a < TILE_KINDS; ++a) {
+            for (int b = 0; b < TILE_KINDS; ++b) {
+                bool related = a != b && (a / 6 == b / 6 || a % 6 == b % 6);
+                slot[a][b] = related ? next++ : -1;
+            }
+        }
+    }
+};
+const PairSlots pairSlots;
+
+int pairFeature(const Tile& first, const Tile& second, bool vertical) {
+    int s = pairSlots.slot[tileIndex(first)][tileIndex(second)];
+    return s < 0 ? -1 : PAIR_BASE + (vertical ? PAIR_SLOTS : 0) + s;
+}
+
+int scoreMargin(const GameState& state) {
+    int own = state.scores[state.currentPlayer];
+    if (state.playerCount() == 1) return own;
+    int best = INT_MIN;
+    for (int p = 0; p < state.playerCount(); ++p) {
+        if (p != state.currentPlayer) best = std::max(best, state.scores[p]);
+    }
+    return own - best;
+}
+
+std::array<std::uint8_t, TILE_KINDS> handCounts(const Hand& hand) {
+    std::array<std::uint8_t, TILE_KINDS> counts{};
+    for (const auto& slot : hand) {
+        if (slot) ++counts[tileIndex(*slot)];
+    }
+    return counts;
+}
+
+// dst &= src and dst &= ~src over n words (a multiple of 4); dst is 32-byte aligned
+void andWords(std::uint64_t* dst, const std::uint64_t* src, size_t n) {
+#if defined(__AVX2__)
+    for (size_t i = 0; i < n; i += 4) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_and_si256(a, b));
+    }
+#elif defined(QWIRKLE_SSE2)
+    for (size_t i = 0; i < n; i += 2) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + i), _mm_and_si128(a, b));
+    }
+#else
+    for (size_t i = 0; i < n; ++i) dst[i] &= src[i];
+#endif
+}
+
+void andNotWords(std::uint64_t* dst, const std::uint64_t* src, size_t n) {
+#if defined(__AVX2__)
+    for (size_t i = 0; i < n; i += 4) {
+        __m256i a = _mm256_load_si256(reinterpret_cast<const __m256i*>(dst + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_andnot_si256(b, a));
+    }
+#elif defined(QWIRKLE_SSE2)
+    for (size_t i = 0; i < n; i += 2) {
+        __m128i a = _mm_load_si128(reinterpret_cast<const __m128i*>(dst + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_store_si128(reinterpret_cast<__m128i*>(dst + i), _mm_andnot_si128(b, a));
+    }
+#else
+    for (size_t i = 0; i < n; ++i) dst[i] &= ~src[i];
+#endif
+}
+
+// Features a query requires (include) or forbids (exclude)
+struct Plan {
+    std::vector<int> include;
+    std::vector<int> exclude;
+    bool marginCheck = false; // bounds fall between thresholds: check the stored margin
+    bool replay = false;      // pattern the pair features can't decide alone
+    bool impossible = false;
+};
+
+Plan makePlan(const PositionQuery& q) {
+    Plan plan;
+    const auto& cells = q.pattern;
+    for (size_t i = 0; i < cells.size(); ++i) {
+        plan.include.push_back(PRESENT_BASE + tileIndex(cells[i].tile));
+        for (size_t j = 0; j < cells.size(); ++j) {
+            int dx = cells[j].pos.first - cells[i].pos.first;
+            int dy = cells[j].pos.second - cells[i].pos.second;
+            if (dx == 0 && dy == 0 && i != j) plan.impossible = true; // two tiles in one cell
+            if ((dx == 1 && dy == 0) || (dx == 0 && dy == 1)) {
+                int f = pairFeature(cells[i].tile, cells[j].tile, dy == 1);
+                if (f < 0) plan.impossible = true; // can never be adjacent legally
+                else plan.include.push_back(f);
+            }
+        }
+    }
+    // One tile, or two adjacent ones, are decided by the features alone
+    bool adjacentPair = cells.size() == 2
+        && std::abs(cells[0].pos.first - cells[1].pos.first) + std::abs(cells[0].pos.second - cells[1].pos.second) == 1;
+    if (cells.size() > 2 || (cells.size() == 2 && !adjacentPair)) plan.replay = true;
+
+    for (int t = 0; t < TILE_KINDS; ++t) {
+        int copies = q.hand[t];
+        if (copies > TILES_PER_KIND) plan.impossible = true;
+        else if (copies > 0) plan.include.push_back(HAND_BASE + t * 3 + copies - 1);
+    }
+
+    if (q.minMargin) {
+        int best = -1;
+        for (int i = 0; i < MARGIN_COUNT; ++i) {
+            if (MARGIN_THRESHOLDS[i] <= *q.minMargin) best = i;
+        }
+        if (best >= 0) plan.include.push_back(MARGIN_BASE + best);
+        if (best < 0 || MARGIN_THRESHOLDS[best] != *q.minMargin) plan.marginCheck = true;
+    }
+    if (q.maxMargin) {
+        // margin <= M is "not margin >= M + 1"
+        int best = -1;
+        for (int i = MARGIN_COUNT - 1; i >= 0; --i) {
+            if (MARGIN_THRESHOLDS[i] >= *q.maxMargin + 1) best = i;
+        }
+        if (best >= 0) plan.exclude.push_back(MARGIN_BASE + best);
+        if (best < 0 || MARGIN_THRESHOLDS[best] != *q.maxMargin + 1) plan.marginCheck = true;
+    }
+    if (q.minMargin && q.maxMargin && *q.minMargin > *q.maxMargin) plan.impossible = true;
+
+    // Duplicates come from repeated pattern tiles; dropping them saves passes
+    std::sort(plan.include.begin(), plan.include.end());
+    plan.include.erase(std::unique(plan.include.begin(), plan.include.end()), plan.include.end());
+    return plan;
+}
+
+template <class T>
+void writeRaw(std::ostream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof value);
+}
+
+template <class T>
+bool readRaw(std::istream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof value));
+}
+
+} // namespace
+
+bool PositionQuery::parse(const std::string& text) {
+    *this = PositionQuery{};
+    std::istringstream clauses(text);
+    std::string clause;
+    while (std::getline(clauses, clause, ';')) {
+        std::istringstream in(clause);
+        std::string word;
+        if (!(in >> word)) continue;
+        if (word == "pattern") {
+            std::string rest;
+            std::getline(in, rest);
+            rest.erase(0, rest.find_first_not_of(' '));
+            Move cells;
+            if (!parseMove(rest, cells) || cells.empty()) return false;
+            pattern.assign(cells.begin(), cells.end());
+        } else if (word == "hand") {
+            int index;
+            while (in >> index) {
+                if (index < 0 || index >= TILE_KINDS) return false;
+                ++hand[index];
+            }
+            if (!in.eof()) return false;
+        } else if (word == "margin") {
+            std::string op;
+            int value;
+            if (!(in >> op >> value)) return false;
+            if (op == ">=") minMargin = value;
+            else if (op == ">") minMargin = value + 1;
+            else if (op == "<=") maxMargin = value;
+            else if (op == "<") maxMargin = value - 1;
+            else if (op == "=") minMargin = maxMargin = value;
+            else return false;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PositionQuery::matches(const GameState& state) const {
+    auto counts = handCounts(state.hand());
+    for (int t = 0; t < TILE_KINDS; ++t) {
+        if (counts[t] < hand[t]) return false;
+    }
+    if (minMargin || maxMargin) {
+        int margin = scoreMargin(state);
+        if (minMargin && margin < *minMargin) return false;
+        if (maxMargin && margin > *maxMargin) return false;
+    }
+    if (pattern.empty()) return true;
+
+    // Anchor the first cell on each board tile of its kind, then check the rest
+    const Placement& anchor = pattern.front();
+    for (const auto& [pos, tile] : state.board.getTiles()) {
+        if (tile != anchor.tile) continue;
+        int ox = pos.first - anchor.pos.first;
+        int oy = pos.second - anchor.pos.second;
+        bool all = true;
+        for (const Placement& p : pattern) {
+            const Tile* t = state.board.tileAt(ox + p.pos.first, oy + p.pos.second);
+            if (!t || *t != p.tile) {
+                all = false;
+                break;
+            }
+        }
+        if (all) return true;
+    }
+    return false;
+}
+
+std::uint64_t PositionIndex::fingerprint(const std::vector<GameRecord>& games) {
+    std::uint64_t h = zobrist::mix(games.size());
+    for (const GameRecord& g : games) {
+        h = zobrist::mix(h ^ g.seed);
+        h = zobrist::mix(h ^ static_cast<std::uint64_t>(g.players));
+        for (const Move& m : g.moves) {
+            h = zobrist::mix(h ^ m.size());
+            for (const Placement& p : m) h ^= zobrist::key(p.pos.first, p.pos.second, p.tile);
+        }
+    }
+    return h;
+}
+
+PositionIndex::Hit PositionIndex::locate(std::uint64_t id) const {
+    auto it = std::upper_bound(gameStart.begin(), gameStart.end(), id) - 1;
+    return Hit{ static_cast<std::uint32_t>(it - gameStart.begin()), static_cast<std::uint32_t>(id - *it) };
+}
+
+void PositionIndex::setFeatures(const GameState& state, std::uint64_t id) {
+    const Board& board = state.board;
+    for (const auto& [pos, tile] : board.getTiles()) {
+        set(PRESENT_BASE + tileIndex(tile), id);
+        if (const Tile* right = board.tileAt(pos.first + 1, pos.second)) {
+            int f = pairFeature(tile, *right, false);
+            if (f >= 0) set(f, id);
+        }
+        if (const Tile* below = board.tileAt(pos.first, pos.second + 1)) {
+            int f = pairFeature(tile, *below, true);
+            if (f >= 0) set(f, id);
+        }
+    }
+    auto counts = handCounts(state.hand());
+    for (int t = 0; t < TILE_KINDS; ++t) {
+        for (int k = 0; k < std::min<int>(counts[t], TILES_PER_KIND); ++k) set(HAND_BASE + t * 3 + k, id);
+    }
+    int margin = scoreMargin(state);
+    margins[id] = static_cast<std::int16_t>(margin);
+    for (int i = 0; i < MARGIN_COUNT && margin >= MARGIN_THRESHOLDS[i]; ++i) set(MARGIN_BASE + i, id);
+}
+
+void PositionIndex::build(const std::vector<GameRecord>& games, int threads) {
+    gameStart.assign(1, 0);
+    for (const GameRecord& g : games) gameStart.push_back(gameStart.back() + g.moves.size() + 1);
+    positions = gameStart.back();
+    size_t words = (positions + 63) / 64;
+    stride = (words + 3) & ~size_t{3}; // whole SIMD vectors per row
+    bits.assign(FEATURE_COUNT * stride, 0);
+    margins.assign(positions, 0);
+    archiveHash = fingerprint(games);
+    if (positions == 0) return;
+
+    // Ranges own disjoint words, so no two of them write the same word. Each
+    // one replays up to its first position and walks forward.
+    ThreadPool& pool = ThreadPool::shared();
+    size_t ranges = std::min<size_t>(threads > 0 ? threads : pool.size(), words);
+    pool.parallelFor(0, ranges, [&](size_t r) {
+        std::uint64_t first = words * r / ranges * 64;
+        std::uint64_t last = std::min<std::uint64_t>(words * (r + 1) / ranges * 64, positions);
+        Hit at = locate(first);
+        GameState state = games[at.game].replay(at.ply);
+        for (std::uint64_t id = first; id < last; ++id) {
+            setFeatures(state, id);
+            const GameRecord& g = games[at.game];
+            if (at.ply < g.moves.size()) {
+                state.applyMove(g.moves[at.ply++]);
+            } else if (id + 1 < last) {
+                at = Hit{ at.game + 1, 0 };
+                state = games[at.game].replay(0);
+            }
+        }
+    });
+}
+
+PositionIndex::Result PositionIndex::query(const PositionQuery& q, const std::vector<GameRecord>& games, size_t limit) const {
+    Result result;
+    Plan plan = makePlan(q);
+    result.exact = !plan.replay;
+    if (plan.impossible || positions == 0) return result;
+
+    // Replay cursor for checking inexact candidates; moves forward within a game
+    std::optional<GameState> state;
+    Hit cursor{ UINT32_MAX, 0 };
+    auto verify = [&](std::uint64_t id) {
+        Hit at = locate(id);
+        if (!state || at.game != cursor.game || at.ply < cursor.ply) {
+            state = games[at.game].replay(at.ply);
+        } else {
+            for (; cursor.ply < at.ply; ++cursor.ply) state->applyMove(games[at.game].moves[cursor.ply]);
+        }
+        cursor = at;
+        return q.matches(*state);
+    };
+
+    alignas(32) std::uint64_t acc[BLOCK_WORDS];
+    size_t words = (positions + 63) / 64;
+    for (size_t base = 0; base < stride; base += BLOCK_WORDS) {
+        size_t n = std::min(BLOCK_WORDS, stride - base);
+        if (plan.include.empty()) {
+            std::fill(acc, acc + n, ~std::uint64_t{0});
+        } else {
+            std::memcpy(acc, row(plan.include[0]) + base, n * sizeof(std::uint64_t));
+        }
+        for (size_t i = 1; i < plan.include.size(); ++i) andWords(acc, row(plan.include[i]) + base, n);
+        for (int f : plan.exclude) andNotWords(acc, row(f) + base, n);
+
+        // Clear padding past the last position
+        for (size_t i = 0; i < n; ++i) {
+            size_t w = base + i;
+            if (w >= words) acc[i] = 0;
+            else if (w == words - 1 && positions % 64) acc[i] &= (std::uint64_t{1} << (positions % 64)) - 1;
+        }
+
+        for (size_t i = 0; i < n; ++i) {
+            std::uint64_t word = acc[i];
+            if (!word) continue;
+            if (!plan.marginCheck) result.candidates += std::bitset<64>(word).count();
+            while (word) {
+                bool full = limit != 0 && result.hits.size() >= limit;
+                if (full && !plan.marginCheck) break; // counted already
+                int bit = static_cast<int>(std::bitset<64>((word & (~word + 1)) - 1).count()); // lowest set bit
+                word &= word - 1;
+                std::uint64_t id = (base + i) * 64 + bit;
+                if (plan.marginCheck) {
+                    int margin = margins[id];
+                    if ((q.minMargin && margin < *q.minMargin) || (q.maxMargin && margin > *q.maxMargin)) continue;
+                    ++result.candidates;
+                }
+                if (!full && (!plan.replay || verify(id))) result.hits.push_back(locate(id));
+            }
+        }
+    }
+    return result;
+}
+
+// Host byte order; index files are a local cache next to the archive:
+// "QWKI" version archiveHash games positions stride features,
+// then gameStart[games + 1], the bitsets and the margins
+bool PositionIndex::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return false;
+    out.write("QWKI", 4);
+    writeRaw(out, INDEX_VERSION);
+    writeRaw(out, archiveHash);
+    writeRaw(out, static_cast<std::uint64_t>(gameCount()));
+    writeRaw(out, positions);
+    writeRaw(out, static_cast<std::uint64_t>(stride));
+    writeRaw(out, static_cast<std::uint32_t>(FEATURE_COUNT));
+    out.write(reinterpret_cast<const char*>(gameStart.data()), gameStart.size() * sizeof(std::uint64_t));
+    out.write(reinterpret_cast<const char*>(bits.data()), bits.size() * sizeof(std::uint64_t));
+    out.write(reinterpret_cast<const char*>(margins.data()), margins.size() * sizeof(std::int16_t));
+    return static_cast<bool>(out);
+}
+
+bool PositionIndex::load(const std::string& path, const std::vector<GameRecord>& games) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[4];
+    std::uint32_t version = 0, features = 0;
+    std::uint64_t hash = 0, gameTotal = 0, positionTotal = 0, words = 0;
+    if (!in.read(magic, 4) || std::memcmp(magic, "QWKI", 4) != 0) return false;
+    if (!readRaw(in, version) || version != INDEX_VERSION) return false;
+    if (!readRaw(in, hash) || !readRaw(in, gameTotal) || !readRaw(in, positionTotal)
+        || !readRaw(in, words) || !readRaw(in, features)) return false;
+    if (features != FEATURE_COUNT || gameTotal != games.size() || hash != fingerprint(games)) return false;
+
+    std::vector<std::uint64_t> starts(gameTotal + 1);
+    std::vector<std::uint64_t> data(FEATURE_COUNT * words);
+    if (!in.read(reinterpret_cast<char*>(starts.data()), starts.size() * sizeof(std::uint64_t))) return false;
+    if (!in.read(reinterpret_cast<char*>(data.data()), data.size() * sizeof(std::uint64_t))) return false;
+    if (starts.back() != positionTotal) return false;
+    std::vector<std::int16_t> marginData(positionTotal);
+    if (!in.read(reinterpret_cast<char*>(marginData.data()), marginData.size() * sizeof(std::int16_t))) return false;
+
+    gameStart = std::move(starts);
+    bits = std::move(data);
+    margins = std::move(marginData);
+    positions = positionTotal;
+    stride = words;
+    archiveHash = hash;
+    return true;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include "GameRecord.h"
+#include "Move.h"
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// A position pattern to search archives for. Every clause given must hold:
+//  - pattern: tiles at relative cells, matched anywhere on the board
+//  - hand: tiles the side to move holds (a tile listed twice needs two copies)
+//  - margin: side to move's score minus the best opponent's (own score solo)
+struct PositionQuery {
+    std::vector<Placement> pattern;
+    std::array<std::uint8_t, TILE_KINDS> hand{};
+    std::optional<int> minMargin;
+    std::optional<int> maxMargin;
+
+    // Clauses separated by ';', e.g.
+    //     pattern 0,0,7 1,0,9 ; hand 7 7 12 ; margin >= 10 ; margin <= 40
+    // Pattern cells use the x,y,tileIndex form of game records.
+    bool parse(const std::string& text);
+    bool matches(const GameState& state) const;
+};
+
+// Inverted index over every position (before each move, plus the final one)
+// of a game archive. Each feature owns a bitset with one bit per position:
+//  - a tile kind next to another kind, horizontally or vertically
+//  - a tile kind on the board
+//  - at least k copies of a kind in the side to move's hand
+//  - score margin at or above a threshold
+// Adjacent pairs are translation-invariant, so a pattern maps to the pairs it
+// contains. A query ANDs (and ANDNOTs, for upper margin bounds) the bitsets
+// of its features block by block with SIMD. Margin bounds between thresholds
+// are checked against a stored per-position margin; patterns the pairs can't
+// decide alone are checked by replaying the candidate's game. Costs about 110
+// bytes per indexed position.
+class PositionIndex {
+public:
+    struct Hit {
+        std::uint32_t game;
+        std::uint32_t ply; // moves applied before the position
+    };
+
+    struct Result {
+        std::vector<Hit> hits;        // up to the requested limit, in archive order
+        std::uint64_t candidates = 0; // positions passing the bitset and margin filters
+        bool exact = false;           // candidates == matches, no pattern replay needed
+    };
+
+    // Replays the games in `threads` ranges on the shared pool (0 = one per
+    // worker)
+    void build(const std::vector<GameRecord>& games, int threads = 0);
+
+    // Index files are tied to the archive they were built from
+    bool save(const std::string& path) const;
+    bool load(const std::string& path, const std::vector<GameRecord>& games);
+
+    // limit 0 reports every match
+    Result query(const PositionQuery& q, const std::vector<GameRecord>& games, size_t limit = 0) const;
+
+    std::uint64_t positionCount() const { return positions; }
+    size_t gameCount() const { return gameStart.empty() ? 0 : gameStart.size() - 1; }
+    size_t sizeBytes() const { return bits.size() * sizeof(std::uint64_t); }
+
+    static std::uint64_t fingerprint(const std::vector<GameRecord>& games);
+
+private:
+    Hit locate(std::uint64_t id) const;
+    void setFeatures(const GameState& state, std::uint64_t id);
+    void set(int feature, std::uint64_t id) {
+        bits[feature * stride + id / 64] |= std::uint64_t{1} << (id % 64);
+    }
+    const std::uint64_t* row(int feature) const { return bits.data() + feature * stride; }
+
+    std::vector<std::uint64_t> gameStart; // first position id of each game, plus the total
+    std::uint64_t positions = 0;
+    size_t stride = 0; // words per feature bitset
+    std::vector<std::uint64_t> bits; // feature-major
+    std::vector<std::int16_t> margins; // per position, for bounds between thresholds
+    std::uint64_t archiveHash = 0;
+};
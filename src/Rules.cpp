@@ -0,0 +1,127 @@
+#include "Rules.h"
+
+namespace rules {
+
+namespace {
+
+// Tile at a cell, looking at the move's placements before the board
+const Tile* tileAt(const Board& board, const Move& move, int x, int y) {
+    for (const Placement& p : move) {
+        if (p.pos.first == x && p.pos.second == y) return &p.tile;
+    }
+    return board.tileAt(x, y);
+}
+
+} // namespace
+
+// Stretches of board tiles are taken whole from their segments
+LineMasks lineThrough(const Board& board, const Move& move, int x, int y, int dx, int dy) {
+    auto placed = [&](int cx, int cy) -> const Tile* {
+        for (const Placement& p : move) {
+            if (p.pos.first == cx && p.pos.second == cy) return &p.tile;
+        }
+        return nullptr;
+    };
+    bool vertical = dy != 0;
+    int sx = x, sy = y;
+    for (;;) {
+        int px = sx - dx, py = sy - dy;
+        if (placed(px, py)) {
+            sx = px;
+            sy = py;
+        } else if (const Segment* s = board.segmentAt(px, py, vertical)) {
+            sx = vertical ? px : s->start;
+            sy = vertical ? s->start : py;
+        } else {
+            break;
+        }
+    }
+    LineMasks line;
+    for (;;) {
+        if (const Tile* t = placed(sx, sy)) {
+            addToLine(line, *t);
+            sx += dx;
+            sy += dy;
+        } else if (const Segment* s = board.segmentAt(sx, sy, vertical)) {
+            addToLine(line, *s); // (sx, sy) is its first cell
+            (vertical ? sy : sx) = s->end();
+        } else {
+            break;
+        }
+    }
+    return line;
+}
+
+bool validateMove(const Board& board, const Move& move) {
+    if (move.empty() || move.size() > MAX_LINE) return false;
+
+    const Placement& first = move.placements[0];
+    bool sameRow = true, sameCol = true;
+    for (int i = 0; i < move.size(); ++i) {
+        const Coord& c = move.placements[i].pos;
+        if (board.isOccupied(c.first, c.second)) return false;
+        for (int j = 0; j < i; ++j) {
+            if (move.placements[j].pos == c) return false;
+        }
+        sameRow = sameRow && c.second == first.pos.second;
+        sameCol = sameCol && c.first == first.pos.first;
+    }
+    if (!sameRow && !sameCol) return false;
+
+    // No holes between the placed tiles
+    if (move.size() > 1) {
+        int lo = sameRow ? first.pos.first : first.pos.second;
+        int hi = lo;
+        for (const Placement& p : move) {
+            int v = sameRow ? p.pos.first : p.pos.second;
+            lo = v < lo ? v : lo;
+            hi = v > hi ? v : hi;
+        }
+        for (int v = lo; v <= hi; ++v) {
+            int x = sameRow ? v : first.pos.first;
+            int y = sameRow ? first.pos.second : v;
+            if (!tileAt(board, move, x, y)) return false;
+        }
+    }
+
+    // Must touch the existing tiles (except on the opening move)
+    if (!board.empty()) {
+        bool touches = false;
+        for (const Placement& p : move) {
+            int x = p.pos.first, y = p.pos.second;
+            if (board.isOccupied(x + 1, y) || board.isOccupied(x - 1, y)
+                || board.isOccupied(x, y + 1) || board.isOccupied(x, y - 1)) {
+                touches = true;
+                break;
+            }
+        }
+        if (!touches) return false;
+    }
+
+    // Every line through every placed tile must be legal
+    for (const Placement& p : move) {
+        if (!isValidLine(lineThrough(board, move, p.pos.first, p.pos.second, 1, 0))) return false;
+        if (!isValidLine(lineThrough(board, move, p.pos.first, p.pos.second, 0, 1))) return false;
+    }
+    return true;
+}
+
+int scoreMove(const Board& board, const Move& move) {
+    if (move.empty()) return 0;
+    const Placement& first = move.placements[0];
+    // A single tile has no main axis: both of its lines count as cross lines
+    bool alongRow = move.size() > 1 && move.placements[1].pos.second == first.pos.second;
+    bool alongCol = move.size() > 1 && !alongRow;
+
+    int score = 0;
+    if (alongRow) score += scoreLine(lineThrough(board, move, first.pos.first, first.pos.second, 1, 0).length);
+    if (alongCol) score += scoreLine(lineThrough(board, move, first.pos.first, first.pos.second, 0, 1).length);
+    for (const Placement& p : move) {
+        if (!alongRow) score += scoreLine(lineThrough(board, move, p.pos.first, p.pos.second, 1, 0).length);
+        if (!alongCol) score += scoreLine(lineThrough(board, move, p.pos.first, p.pos.second, 0, 1).length);
+    }
+    // A lone tile on an empty board still scores a point
+    return score > 0 ? score : 1;
+}
+
+} // namespace rules
@@ -0,0 +1,59 @@
+#pragma once
+#include "Board.h"
+#include "Move.h"
+#include <bitset>
+
+// Qwirkle placement rules and scoring.
+// A move places 1-6 tiles in one row or column, contiguous with (possibly
+// through) existing tiles, touching the existing board unless it is the
+// first move. Every line of two or more tiles it creates must share a color
+// with all-different shapes, or a shape with all-different colors.
+namespace rules {
+
+constexpr int MAX_LINE = 6;
+constexpr int QWIRKLE_BONUS = 6;
+constexpr int GOING_OUT_BONUS = 6; // for emptying your hand once the bag is empty
+
+// Color/shape bitmasks of a run of tiles
+struct LineMasks {
+    int length = 0;
+    unsigned colors = 0; // bit per Color
+    unsigned shapes = 0; // bit per Shape
+};
+
+inline void addToLine(LineMasks& line, const Tile& t) {
+    ++line.length;
+    line.colors |= 1u << static_cast<int>(t.color);
+    line.shapes |= 1u << static_cast<int>(t.shape);
+}
+
+inline void addToLine(LineMasks& line, const Segment& s) {
+    line.length += s.length;
+    line.colors |= s.colors;
+    line.shapes |= s.shapes;
+}
+
+// A line is legal when it shares one attribute and the other is all-distinct
+inline bool isValidLine(const LineMasks& line) {
+    if (line.length <= 1) return true;
+    if (line.length > MAX_LINE) return false;
+    auto bits = [](unsigned m) { return static_cast<int>(std::bitset<8>(m).count()); };
+    return (bits(line.colors) == 1 && bits(line.shapes) == line.length)
+        || (bits(line.shapes) == 1 && bits(line.colors) == line.length);
+}
+
+inline int scoreLine(int length) {
+    if (length < 2) return 0;
+    return length == MAX_LINE ? length + QWIRKLE_BONUS : length;
+}
+
+// Maximal run through the placed cell (x, y) along (dx, dy), counting the
+// move's other placements; assumes none of them is on an occupied cell
+LineMasks lineThrough(const Board& board, const Move& move, int x, int y, int dx, int dy);
+
+bool validateMove(const Board& board, const Move& move);
+
+// Points for a move; assumes validateMove() passed
+int scoreMove(const Board& board, const Move& move);
+
+} // namespace rules
@@ -0,0 +1,468 @@
+#include "SaveGame.h"
+#include "JsonReader.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <istream>
+#include <iterator>
+#include <limits>
+#include <ostream>
+#include <utility>
+
+namespace savegame {
+
+namespace {
+
+bool readTileIndex(std::istream& in, int& index) {
+    return static_cast<bool>(in >> index) && index >= 0 && index < TILE_KINDS;
+}
+
+bool fitsInt(std::int64_t v) {
+    return v >= std::numeric_limits<int>::min() && v <= std::numeric_limits<int>::max();
+}
+
+// Expect a literal keyword
+bool expect(std::istream& in, const char* word) {
+    std::string token;
+    return static_cast<bool>(in >> token) && token == word;
+}
+
+} // namespace
+
+// qwirkle-state 2
+// players P current C over 0|1
+// scores s0 s1 ...
+// board N            followed by N lines "x y tile"
+// bag M t0 t1 ...    bottom of the bag first
+// hand t|- x6        one line per player
+// rng s0 s1 s2 s3   engine state words
+void writeText(std::ostream& out, const GameState& state) {
+    out << "qwirkle-state 2\n";
+    out << "players " << state.playerCount() << " current " << state.currentPlayer
+        << " over " << (state.gameOver ? 1 : 0) << "\n";
+    out << "scores";
+    for (int s : state.scores) out << ' ' << s;
+    out << "\nboard " << state.board.getTiles().size() << "\n";
+    for (const auto& t : state.board.getTiles()) {
+        out << t.first.first << ' ' << t.first.second << ' ' << tileIndex(t.second) << "\n";
+    }
+    out << "bag " << state.tileBag.size();
+    for (const Tile& t : state.tileBag) out << ' ' << tileIndex(t);
+    out << "\n";
+    for (const Hand& h : state.hands) {
+        out << "hand";
+        for (const auto& slot : h) {
+            if (slot) out << ' ' << tileIndex(*slot);
+            else out << " -";
+        }
+        out << "\n";
+    }
+    out << "rng";
+    for (std::uint64_t word : state.rng.state) out << ' ' << word;
+    out << "\n";
+}
+
+bool readText(std::istream& in, GameState& state) {
+    int version = 0, players = 0, current = 0, over = 0;
+    if (!expect(in, "qwirkle-state") || !(in >> version) || version != 2) return false;
+    if (!expect(in, "players") || !(in >> players) || players < 1 || players > MAX_PLAYERS) return false;
+    if (!expect(in, "current") || !(in >> current) || current < 0 || current >= players) return false;
+    if (!expect(in, "over") || !(in >> over)) return false;
+
+    GameState loaded(players, 0);
+    loaded.currentPlayer = current;
+    loaded.gameOver = over != 0;
+
+    if (!expect(in, "scores")) return false;
+    for (int& s : loaded.scores) {
+        if (!(in >> s)) return false;
+    }
+
+    size_t count = 0;
+    if (!expect(in, "board") || !(in >> count)) return false;
+    for (size_t i = 0; i < count; ++i) {
+        int x, y, index;
+        if (!(in >> x >> y) || !readTileIndex(in, index) || loaded.board.isOccupied(x, y)) return false;
+        loaded.board.placeTile(x, y, tileFromIndex(index));
+    }
+
+    if (!expect(in, "bag") || !(in >> count) || count > TOTAL_TILES) return false;
+    loaded.tileBag.resize(count);
+    for (Tile& t : loaded.tileBag) {
+        int index;
+        if (!readTileIndex(in, index)) return false;
+        t = tileFromIndex(index);
+    }
+
+    for (Hand& h : loaded.hands) {
+        if (!expect(in, "hand")) return false;
+        for (auto& slot : h) {
+            std::string token;
+            if (!(in >> token)) return false;
+            if (token == "-") {
+                slot.reset();
+                continue;
+            }
+            char* end = nullptr;
+            long index = std::strtol(token.c_str(), &end, 10);
+            if (end == token.c_str() || *end != '\0' || index < 0 || index >= TILE_KINDS) return false;
+            slot = tileFromIndex(static_cast<int>(index));
+        }
+    }
+
+    if (!expect(in, "rng")) return false;
+    for (std::uint64_t& word : loaded.rng.state) {
+        if (!(in >> word)) return false;
+    }
+
+    state = std::move(loaded);
+    return true;
+}
+
+// ---- binary ----
+//
+// "QWKB" u8 version, u8 players, u8 current, u8 over
+// i32 score x players
+// u16 tile count, then i32 x, i32 y, u8 tile per board tile (i16 in version 1)
+// u8 bag count, u8 tile per bag entry (bottom first)
+// u8 x 6 per hand (NO_TILE for an empty slot)
+// u64 x 4 RNG engine state
+// All integers little-endian; nothing may follow the RNG words.
+
+namespace {
+
+constexpr char BINARY_MAGIC[4] = {'Q', 'W', 'K', 'B'};
+constexpr std::uint8_t BINARY_VERSION = 2;
+constexpr std::uint8_t NO_TILE = 0xFF;
+
+void putU8(std::string& out, std::uint8_t v) { out += static_cast<char>(v); }
+
+void putU16(std::string& out, std::uint16_t v) {
+    out += static_cast<char>(v & 0xFF);
+    out += static_cast<char>(v >> 8);
+}
+
+void putU64(std::string& out, std::uint64_t v) {
+    for (int i = 0; i < 8; ++i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+void putI32(std::string& out, std::int32_t value) {
+    auto v = static_cast<std::uint32_t>(value);
+    for (int i = 0; i < 4; ++i) out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+struct ByteReader {
+    const unsigned char* p;
+    const unsigned char* end;
+
+    bool u8(std::uint8_t& v) {
+        if (end - p < 1) return false;
+        v = *p++;
+        return true;
+    }
+    bool u16(std::uint16_t& v) {
+        if (end - p < 2) return false;
+        v = static_cast<std::uint16_t>(p[0] | p[1] << 8);
+        p += 2;
+        return true;
+    }
+    bool i32(std::int32_t& v) {
+        if (end - p < 4) return false;
+        v = static_cast<std::int32_t>(static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8
+                                      | static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24);
+        p += 4;
+        return true;
+    }
+    bool u64(std::uint64_t& v) {
+        if (end - p < 8) return false;
+        v = 0;
+        for (int i = 7; i >= 0; --i) v = v << 8 | p[i];
+        p += 8;
+        return true;
+    }
+    bool tile(Tile& t) {
+        std::uint8_t index;
+        if (!u8(index) || index >= TILE_KINDS) return false;
+        t = tileFromIndex(index);
+        return true;
+    }
+};
+
+// JSON numbers are not safe beyond 2^53, so engine words go in a hex string
+std::string rngHex(const Rng& rng) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex;
+    for (std::uint64_t word : rng.state) {
+        if (!hex.empty()) hex += ' ';
+        for (int shift = 60; shift >= 0; shift -= 4) hex += digits[(word >> shift) & 0xF];
+    }
+    return hex;
+}
+
+bool setRngHex(std::string_view hex, Rng& rng) {
+    size_t pos = 0;
+    for (std::uint64_t& word : rng.state) {
+        while (pos < hex.size() && hex[pos] == ' ') ++pos;
+        word = 0;
+        size_t digits = 0;
+        for (; pos < hex.size() && hex[pos] != ' '; ++pos, ++digits) {
+            char c = hex[pos];
+            int v = c >= '0' && c <= '9' ? c - '0' : c >= 'a' && c <= 'f' ? c - 'a' + 10 : -1;
+            if (v < 0 || digits == 16) return false;
+            word = word << 4 | static_cast<std::uint64_t>(v);
+        }
+        if (digits == 0) return false;
+    }
+    return pos == hex.size();
+}
+
+} // namespace
+
+void writeBinary(std::string& out, const GameState& state) {
+    out.append(BINARY_MAGIC, sizeof BINARY_MAGIC);
+    putU8(out, BINARY_VERSION);
+    putU8(out, static_cast<std::uint8_t>(state.playerCount()));
+    putU8(out, static_cast<std::uint8_t>(state.currentPlayer));
+    putU8(out, state.gameOver ? 1 : 0);
+    for (int s : state.scores) putI32(out, s);
+
+    putU16(out, static_cast<std::uint16_t>(state.board.getTiles().size()));
+    for (const auto& t : state.board.getTiles()) {
+        putI32(out, t.first.first);
+        putI32(out, t.first.second);
+        putU8(out, static_cast<std::uint8_t>(tileIndex(t.second)));
+    }
+
+    putU8(out, static_cast<std::uint8_t>(state.tileBag.size()));
+    for (const Tile& t : state.tileBag) putU8(out, static_cast<std::uint8_t>(tileIndex(t)));
+
+    for (const Hand& h : state.hands) {
+        for (int i = 0; i < HAND_SIZE; ++i) {
+            bool has = i < static_cast<int>(h.size()) && h[i];
+            putU8(out, has ? static_cast<std::uint8_t>(tileIndex(*h[i])) : NO_TILE);
+        }
+    }
+
+    for (std::uint64_t word : state.rng.state) putU64(out, word);
+}
+
+bool readBinary(const char* data, size_t size, GameState& state) {
+    ByteReader in{reinterpret_cast<const unsigned char*>(data), reinterpret_cast<const unsigned char*>(data) + size};
+    if (size < sizeof BINARY_MAGIC || std::memcmp(data, BINARY_MAGIC, sizeof BINARY_MAGIC) != 0) return false;
+    in.p += sizeof BINARY_MAGIC;
+
+    std::uint8_t version, players, current, over;
+    if (!in.u8(version) || version < 1 || version > BINARY_VERSION) return false;
+    if (!in.u8(players) || players < 1 || players > MAX_PLAYERS || !in.u8(current) || current >= players || !in.u8(over)) return false;
+
+    GameState loaded(players, 0);
+    loaded.currentPlayer = current;
+    loaded.gameOver = over != 0;
+    for (int& s : loaded.scores) {
+        std::int32_t v;
+        if (!in.i32(v)) return false;
+        s = v;
+    }
+
+    std::uint16_t count;
+    if (!in.u16(count)) return false;
+    for (int i = 0; i < count; ++i) {
+        std::int32_t x, y;
+        Tile t;
+        if (version == 1) {
+            std::uint16_t x16, y16;
+            if (!in.u16(x16) || !in.u16(y16)) return false;
+            x = static_cast<std::int16_t>(x16);
+            y = static_cast<std::int16_t>(y16);
+        } else if (!in.i32(x) || !in.i32(y)) {
+            return false;
+        }
+        if (!in.tile(t) || loaded.board.isOccupied(x, y)) return false;
+        loaded.board.placeTile(x, y, t);
+    }
+
+    std::uint8_t bag;
+    if (!in.u8(bag) || bag > TOTAL_TILES) return false;
+    loaded.tileBag.resize(bag);
+    for (Tile& t : loaded.tileBag) {
+        if (!in.tile(t)) return false;
+    }
+
+    for (Hand& h : loaded.hands) {
+        for (auto& slot : h) {
+            std::uint8_t index;
+            if (!in.u8(index)) return false;
+            if (index == NO_TILE) slot.reset();
+            else if (index < TILE_KINDS) slot = tileFromIndex(index);
+            else return false;
+        }
+    }
+
+    for (std::uint64_t& word : loaded.rng.state) {
+        if (!in.u64(word)) return false;
+    }
+    if (in.p != in.end) return false;
+
+    state = std::move(loaded);
+    return true;
+}
+
+// ---- JSON ----
+//
+// {"format":"qwirkle-state","version":1,"players":2,"current":0,"over":false,
+//  "scores":[..],"board":[[x,y,tile],..],"bag":[tile,..],
+//  "hands":[[tile|null x6],..],"rng":"<4 hex engine words>"}
+
+void writeJson(std::string& out, const GameState& state) {
+    auto num = [&](long long v) { out += std::to_string(v); };
+    out += "{\"format\":\"qwirkle-state\",\"version\":1,\"players\":";
+    num(state.playerCount());
+    out += ",\"current\":";
+    num(state.currentPlayer);
+    out += state.gameOver ? ",\"over\":true" : ",\"over\":false";
+
+    out += ",\"scores\":[";
+    for (size_t i = 0; i < state.scores.size(); ++i) {
+        if (i) out += ',';
+        num(state.scores[i]);
+    }
+    out += "],\"board\":[";
+    bool first = true;
+    for (const auto& t : state.board.getTiles()) {
+        out += first ? "[" : ",[";
+        first = false;
+        num(t.first.first);
+        out += ',';
+        num(t.first.second);
+        out += ',';
+        num(tileIndex(t.second));
+        out += ']';
+    }
+    out += "],\"bag\":[";
+    for (size_t i = 0; i < state.tileBag.size(); ++i) {
+        if (i) out += ',';
+        num(tileIndex(state.tileBag[i]));
+    }
+    out += "],\"hands\":[";
+    for (size_t p = 0; p < state.hands.size(); ++p) {
+        out += p ? ",[" : "[";
+        for (size_t i = 0; i < state.hands[p].size(); ++i) {
+            if (i) out += ',';
+            if (state.hands[p][i]) num(tileIndex(*state.hands[p][i]));
+            else out += "null";
+        }
+        out += ']';
+    }
+    out += "],\"rng\":\"" + rngHex(state.rng) + "\"}\n";
+}
+
+namespace {
+
+bool readTileValue(JsonReader& r, Tile& t) {
+    std::int64_t index;
+    if (!r.readInt(index) || index < 0 || index >= TILE_KINDS) return false;
+    t = tileFromIndex(static_cast<int>(index));
+    return true;
+}
+
+} // namespace
+
+bool readJson(const char* data, size_t size, GameState& state) {
+    JsonReader r(data, size);
+    if (!r.beginObject()) return false;
+
+    // "players" must come before any of the state it sizes
+    GameState loaded(1, 0);
+    bool havePlayers = false, haveRng = false;
+    std::string_view key;
+    while (r.nextKey(key)) {
+        std::int64_t v;
+        bool header = key == "format" || key == "version" || key == "players";
+        if (!header && !havePlayers) return false;
+        if (key == "format") {
+            std::string_view format;
+            if (!r.readString(format) || format != "qwirkle-state") return false;
+        } else if (key == "version") {
+            if (!r.readInt(v) || v != 1) return false;
+        } else if (key == "players") {
+            if (havePlayers || !r.readInt(v) || v < 1 || v > MAX_PLAYERS) return false;
+            loaded = GameState(static_cast<int>(v), 0);
+            havePlayers = true;
+        } else if (key == "current") {
+            if (!r.readInt(v) || v < 0 || v >= loaded.playerCount()) return false;
+            loaded.currentPlayer = static_cast<int>(v);
+        } else if (key == "over") {
+            if (!r.readBool(loaded.gameOver)) return false;
+        } else if (key == "scores") {
+            if (!r.beginArray()) return false;
+            for (size_t i = 0; r.nextElement(); ++i) {
+                if (i >= loaded.scores.size() || !r.readInt(v) || !fitsInt(v)) return false;
+                loaded.scores[i] = static_cast<int>(v);
+            }
+        } else if (key == "board") {
+            if (!r.beginArray()) return false;
+            while (r.nextElement()) {
+                std::int64_t x, y;
+                Tile t;
+                if (!r.beginArray() || !r.nextElement() || !r.readInt(x) || !r.nextElement() || !r.readInt(y)
+                    || !r.nextElement() || !readTileValue(r, t) || r.nextElement() || !fitsInt(x) || !fitsInt(y)
+                    || loaded.board.isOccupied(static_cast<int>(x), static_cast<int>(y))) {
+                    return false;
+                }
+                loaded.board.placeTile(static_cast<int>(x), static_cast<int>(y), t);
+            }
+        } else if (key == "bag") {
+            if (!r.beginArray()) return false;
+            loaded.tileBag.clear();
+            while (r.nextElement()) {
+                Tile t;
+                if (!readTileValue(r, t) || loaded.tileBag.size() == TOTAL_TILES) return false;
+                loaded.tileBag.push_back(t);
+            }
+        } else if (key == "hands") {
+            if (!r.beginArray()) return false;
+            for (size_t p = 0; r.nextElement(); ++p) {
+                if (p >= loaded.hands.size() || !r.beginArray()) return false;
+                for (size_t i = 0; r.nextElement(); ++i) {
+                    if (i >= HAND_SIZE) return false;
+                    Tile t;
+                    if (r.readNull()) loaded.hands[p][i].reset();
+                    else if (readTileValue(r, t)) loaded.hands[p][i] = t;
+                    else return false;
+                }
+            }
+        } else if (key == "rng") {
+            std::string_view text;
+            if (!r.readString(text) || !setRngHex(text, loaded.rng)) return false;
+            haveRng = true;
+        } else if (!r.skipValue()) {
+            return false;
+        }
+    }
+    // Nothing but whitespace may follow the object
+    if (!r.ok() || !r.atEnd() || !havePlayers || !haveRng) return false;
+
+    state = std::move(loaded);
+    return true;
+}
+
+bool saveToFile(const std::string& path, const GameState& state, Format format) {
+    std::string data;
+    if (format == Format::Binary) writeBinary(data, state);
+    else writeJson(data, state);
+    std::ofstream out(path, std::ios::binary);
+    out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(out);
+}
+
+bool loadFromFile(const std::string& path, GameState& state) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() >= sizeof BINARY_MAGIC && std::memcmp(data.data(), BINARY_MAGIC, sizeof BINARY_MAGIC) == 0) {
+        return readBinary(data.data(), data.size(), state);
+    }
+    return readJson(data.data(), data.size(), state);
+}
+
+} // namespace savegame
@@ -0,0 +1,29 @@
+#pragma once
+#include "GameState.h"
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+
+// Complete game state serialization: board, bag order, hands, scores, turn
+// and RNG state, so a loaded game continues exactly as the saved one would.
+namespace savegame {
+
+// Line-based text form, used for autosave snapshots
+void writeText(std::ostream& out, const GameState& state);
+bool readText(std::istream& in, GameState& state); // false on malformed input
+
+// Compact binary form (appended to `out`); loads in microseconds
+void writeBinary(std::string& out, const GameState& state);
+bool readBinary(const char* data, size_t size, GameState& state);
+
+// JSON form for tooling, read with a streaming parser (no DOM)
+void writeJson(std::string& out, const GameState& state);
+bool readJson(const char* data, size_t size, GameState& state);
+
+enum class Format { Binary, Json };
+
+bool saveToFile(const std::string& path, const GameState& state, Format format);
+// Detects the format from the file contents
+bool loadFromFile(const std::string& path, GameState& state);
+
+} // namespace savegame
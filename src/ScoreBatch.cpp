@@ -0,0 +1,130 @@
+#include "ScoreBatch.h"
+#include "Rules.h"
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define QWIRKLE_SSE2 1
+#endif
+
+void ScoreBatch::clear() {
+    anchor.clear();
+    vertical.clear();
+    mainLength.clear();
+    for (auto& c : crossLength) c.clear();
+}
+
+void ScoreBatch::reserve(std::size_t n) {
+    anchor.reserve(n);
+    vertical.reserve(n);
+    mainLength.reserve(n);
+    for (auto& c : crossLength) c.reserve(n);
+}
+
+void ScoreBatch::push(const Move& move, bool isVertical, int main, const std::uint8_t* cross) {
+    anchor.push_back(move.placements[0].pos);
+    vertical.push_back(isVertical);
+    mainLength.push_back(static_cast<std::uint8_t>(main));
+    for (int i = 0; i < Move::MAX_TILES; ++i) crossLength[i].push_back(i < move.size() ? cross[i] : 0);
+}
+
+void ScoreBatch::add(const Board& board, const Move& move) {
+    auto length = [&](int x, int y, int dx, int dy) {
+        return rules::lineThrough(board, move, x, y, dx, dy).length;
+    };
+
+    const Placement& first = move.placements[0];
+    bool isVertical = move.size() > 1 && move.placements[1].pos.first == first.pos.first;
+    int dx = isVertical ? 0 : 1, dy = isVertical ? 1 : 0;
+    std::uint8_t cross[Move::MAX_TILES];
+    for (int i = 0; i < move.size(); ++i) {
+        const Coord& c = move.placements[i].pos;
+        cross[i] = static_cast<std::uint8_t>(length(c.first, c.second, dy, dx));
+    }
+    push(move, isVertical, length(first.pos.first, first.pos.second, dx, dy), cross);
+}
+
+namespace rules {
+
+namespace {
+
+void scoreRange(const ScoreBatch& batch, std::size_t from, std::size_t to, std::uint8_t* scores, std::uint8_t* qwirkles) {
+    for (std::size_t i = from; i < to; ++i) {
+        int points = scoreLine(batch.mainLength[i]);
+        int q = batch.mainLength[i] == MAX_LINE;
+        for (const auto& cross : batch.crossLength) {
+            points += scoreLine(cross[i]);
+            q += cross[i] == MAX_LINE;
+        }
+        scores[i] = static_cast<std::uint8_t>(points > 0 ? points : 1); // lone opening tile
+        qwirkles[i] = static_cast<std::uint8_t>(q);
+    }
+}
+
+} // namespace
+
+void scoreBatchScalar(const ScoreBatch& batch, std::uint8_t* scores, std::uint8_t* qwirkles) {
+    scoreRange(batch, 0, batch.size(), scores, qwirkles);
+}
+
+// Per lane, with byte lengths L (at most 6, so sums of seven lines fit a
+// byte): points = (L >= 2 ? L : 0) + (L == 6 ? 6 : 0), Qwirkles = L == 6.
+// Batches hold tens of moves, so the last partial chunk goes through a
+// zero-padded copy rather than the scalar loop.
+void scoreBatch(const ScoreBatch& batch, std::uint8_t* scores, std::uint8_t* qwirkles) {
+    std::size_t n = batch.size(), i = 0;
+#if defined(__AVX2__)
+    const __m256i two = _mm256_set1_epi8(2), six = _mm256_set1_epi8(MAX_LINE);
+    const __m256i bonus = _mm256_set1_epi8(QWIRKLE_BONUS), one = _mm256_set1_epi8(1);
+    for (; i + 32 <= n; i += 32) {
+        __m256i points = _mm256_setzero_si256(), q = _mm256_setzero_si256();
+        for (int line = 0; line <= Move::MAX_TILES; ++line) {
+            const std::uint8_t* src = line == 0 ? batch.mainLength.data() : batch.crossLength[line - 1].data();
+            __m256i len = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i counts = _mm256_cmpeq_epi8(_mm256_max_epu8(len, two), len);
+            __m256i full = _mm256_cmpeq_epi8(len, six);
+            points = _mm256_add_epi8(points, _mm256_add_epi8(_mm256_and_si256(len, counts), _mm256_and_si256(full, bonus)));
+            q = _mm256_sub_epi8(q, full); // full lanes are -1
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(scores + i), _mm256_max_epu8(points, one));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(qwirkles + i), q);
+    }
+#endif
+#if defined(__AVX2__) || defined(QWIRKLE_SSE2)
+    const __m128i two16 = _mm_set1_epi8(2), six16 = _mm_set1_epi8(MAX_LINE);
+    const __m128i bonus16 = _mm_set1_epi8(QWIRKLE_BONUS), one16 = _mm_set1_epi8(1);
+    alignas(16) std::uint8_t pad[Move::MAX_TILES + 1][16], padScores[16], padQwirkles[16];
+    while (i < n) {
+        std::size_t lanes = n - i < 16 ? n - i : 16;
+        if (lanes < 16) {
+            std::memset(pad, 0, sizeof pad);
+            std::memcpy(pad[0], batch.mainLength.data() + i, lanes);
+            for (int c = 0; c < Move::MAX_TILES; ++c) std::memcpy(pad[c + 1], batch.crossLength[c].data() + i, lanes);
+        }
+        __m128i points = _mm_setzero_si128(), q = _mm_setzero_si128();
+        for (int line = 0; line <= Move::MAX_TILES; ++line) {
+            const std::uint8_t* src = lanes < 16 ? pad[line]
+                                    : line == 0 ? batch.mainLength.data() + i : batch.crossLength[line - 1].data() + i;
+            __m128i len = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+            __m128i counts = _mm_cmpeq_epi8(_mm_max_epu8(len, two16), len);
+            __m128i full = _mm_cmpeq_epi8(len, six16);
+            points = _mm_add_epi8(points, _mm_add_epi8(_mm_and_si128(len, counts), _mm_and_si128(full, bonus16)));
+            q = _mm_sub_epi8(q, full);
+        }
+        std::uint8_t* outScores = lanes < 16 ? padScores : scores + i;
+        std::uint8_t* outQwirkles = lanes < 16 ? padQwirkles : qwirkles + i;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outScores), _mm_max_epu8(points, one16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(outQwirkles), q);
+        if (lanes < 16) {
+            std::memcpy(scores + i, padScores, lanes);
+            std::memcpy(qwirkles + i, padQwirkles, lanes);
+        }
+        i += lanes;
+    }
+#endif
+    scoreRange(batch, i, n, scores, qwirkles);
+}
+
+} // namespace rules
@@ -0,0 +1,42 @@
+#pragma once
+#include "Board.h"
+#include "Move.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Candidate moves reduced to the line lengths that decide their score, one
+// array per field so the scoring kernel runs across SIMD lanes. A move's
+// score is its main line plus one cross line per placed tile; a single tile
+// counts its row as the main line and its column as the first cross line.
+// Lengths include the move's own tiles; 1 means no line, 0 an unused slot.
+struct ScoreBatch {
+    std::vector<Coord> anchor;            // first placement
+    std::vector<std::uint8_t> vertical;   // main axis is a column
+    std::vector<std::uint8_t> mainLength;
+    std::array<std::vector<std::uint8_t>, Move::MAX_TILES> crossLength; // per placement
+
+    std::size_t size() const { return mainLength.size(); }
+    void clear();
+    void reserve(std::size_t n);
+
+    // `cross` holds one length per placement of `move`
+    void push(const Move& move, bool isVertical, int main, const std::uint8_t* cross);
+
+    // Derives the lengths by walking the board, for moves not produced by
+    // movegen::generateMoves(). Assumes the move is legal.
+    void add(const Board& board, const Move& move);
+};
+
+namespace rules {
+
+// Points and Qwirkles completed for every move in `batch`, matching
+// scoreMove(). `scores` and `qwirkles` need batch.size() entries. Uses AVX2
+// or SSE2 when the build targets them, else scoreBatchScalar().
+void scoreBatch(const ScoreBatch& batch, std::uint8_t* scores, std::uint8_t* qwirkles);
+
+// Portable reference for the kernel above
+void scoreBatchScalar(const ScoreBatch& batch, std::uint8_t* scores, std::uint8_t* qwirkles);
+
+} // namespace rules
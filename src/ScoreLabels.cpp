@@ -0,0 +1,41 @@
+#include "ScoreLabels.h"
+#include <string>
+
+void ScoreLabels::bake(const sf::Font& font, unsigned charSize) {
+    // Fetch every digit first so they are all on the font's page, then take a
+    // copy: other text at this size can't grow the page under our rects
+    for (int d = 0; d < 10; ++d) digits[d] = font.getGlyph('0' + d, charSize, false);
+    glyphs = font.getTexture(charSize);
+    midline = -(digits[0].bounds.top + digits[0].bounds.height / 2);
+    vertices.clear();
+}
+
+void ScoreLabels::clear() {
+    vertices.clear();
+}
+
+void ScoreLabels::add(sf::Vector2f center, int value) {
+    std::string text = std::to_string(value < 0 ? 0 : value);
+    float width = 0;
+    for (char c : text) width += digits[c - '0'].advance;
+
+    float x = center.x - width / 2, baseline = center.y + midline;
+    for (char c : text) {
+        const sf::Glyph& g = digits[c - '0'];
+        float left = x + g.bounds.left, top = baseline + g.bounds.top;
+        float right = left + g.bounds.width, bottom = top + g.bounds.height;
+        float u0 = static_cast<float>(g.textureRect.left), v0 = static_cast<float>(g.textureRect.top);
+        float u1 = u0 + g.textureRect.width, v1 = v0 + g.textureRect.height;
+        vertices.append(sf::Vertex(sf::Vector2f(left, top), color, sf::Vector2f(u0, v0)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, top), color, sf::Vector2f(u1, v0)));
+        vertices.append(sf::Vertex(sf::Vector2f(right, bottom), color, sf::Vector2f(u1, v1)));
+        vertices.append(sf::Vertex(sf::Vector2f(left, bottom), color, sf::Vector2f(u0, v1)));
+        x += g.advance;
+    }
+}
+
+void ScoreLabels::draw(sf::RenderTarget& target, sf::RenderStates states) const {
+    if (vertices.getVertexCount() == 0) return;
+    states.texture = &glyphs;
+    target.draw(vertices, states);
+}
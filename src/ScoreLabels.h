@@ -0,0 +1,28 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <array>
+
+// Small numeric labels, such as prospective scores on hint cells. The digit
+// glyphs are baked once into a private texture. Every label goes into one
+// vertex array, which is rebuilt only when the labels are replaced, so a
+// board full of labels costs one draw call a frame.
+class ScoreLabels : public sf::Drawable {
+public:
+    // Copies the font's digits at `charSize` into the glyph texture
+    void bake(const sf::Font& font, unsigned charSize);
+
+    void clear();
+    // Centered on `center`, in the coordinates of the view it is drawn with
+    void add(sf::Vector2f center, int value);
+    bool empty() const { return vertices.getVertexCount() == 0; }
+    void setColor(sf::Color c) { color = c; }
+
+private:
+    void draw(sf::RenderTarget& target, sf::RenderStates states) const override;
+
+    sf::Texture glyphs;
+    std::array<sf::Glyph, 10> digits;
+    float midline = 0; // from the baseline up to the middle of a digit
+    sf::Color color = sf::Color::Black;
+    sf::VertexArray vertices{sf::Quads};
+};
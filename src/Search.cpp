@@ -0,0 +1,345 @@
+#include "Search.h"
+#include "MoveGen.h"
+#include "Rules.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <numeric>
+
+namespace {
+
+constexpr int INF = 1 << 20;
+constexpr int TT_MOVE_BONUS = 1000; // orders the table's move ahead of any score
+
+// Nonzero 32-bit id of a move for the transposition table's move field
+std::uint32_t moveId(const Move& move) {
+    std::uint64_t h = 0;
+    for (const Placement& p : move) h ^= zobrist::key(p.pos.first, p.pos.second, p.tile);
+    return static_cast<std::uint32_t>(h ^ (h >> 32)) | 1u;
+}
+
+bool sameMove(const Move& a, const Move& b) {
+    if (a.size() != b.size()) return false;
+    for (int i = 0; i < a.size(); ++i) {
+        const Placement& p = a.placements[i];
+        const Placement& q = b.placements[i];
+        if (p.pos != q.pos || tileIndex(p.tile) != tileIndex(q.tile)) return false;
+    }
+    return true;
+}
+
+} // namespace
+
+Move Searcher::bestSoFar() const {
+    std::lock_guard<std::mutex> lock(bestMutex);
+    return best;
+}
+
+void Searcher::publish(const Move& move) {
+    std::lock_guard<std::mutex> lock(bestMutex);
+    best = move;
+}
+
+GameState Searcher::branch(const GameState& state, int ply) {
+    PlyScratch& s = *scratch[ply];
+    s.arena.reset();
+    return GameState(state, &s.resource);
+}
+
+// The flag load is the common path; the clock is only read every few polls,
+// except between move-generation start cells, each of which can take a good
+// fraction of a millisecond
+bool Searcher::shouldStop(bool readClock) {
+    if (stopFlag.load(std::memory_order_relaxed)) return true;
+    if (!hasDeadline) return false;
+    if (!readClock && ++pollCount % CLOCK_CHECK_INTERVAL != 0) return false;
+    if (Clock::now() < deadline) return false;
+    stopFlag.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+int Searcher::evaluate(const GameState& state) const {
+    int own = state.scores[rootPlayer];
+    if (state.playerCount() == 1) return own;
+    int other = -INF;
+    for (int p = 0; p < state.playerCount(); ++p) {
+        if (p != rootPlayer) other = std::max(other, state.scores[p]);
+    }
+    return own - other;
+}
+
+// Table move first, then by immediate score; keeps the first `keep` (0 = all).
+// Polls between moves: when stopped, only the moves scored so far (at least
+// one) are kept. `ranked`, if given, gets each kept move's score and index.
+void Searcher::orderMoves(const GameState& state, MoveList& moves, std::uint64_t key, int keep,
+                          std::vector<Ranked>* ranked) {
+    TTData entry;
+    std::uint32_t ttMove = table.probe(key, entry) ? entry.move : 0;
+    std::vector<int>& score = orderScore;
+    std::vector<int>& priority = orderPriority;
+    score.clear();
+    priority.clear();
+    for (size_t i = 0; i < moves.size(); ++i) {
+        if (i > 0 && shouldStop()) break;
+        score.push_back(rules::scoreMove(state.board, moves[i]));
+        priority.push_back(score.back() + (ttMove && moveId(moves[i]) == ttMove ? TT_MOVE_BONUS : 0));
+    }
+    std::vector<size_t>& order = orderIndex;
+    order.resize(priority.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return priority[a] > priority[b]; });
+    if (keep > 0 && order.size() > static_cast<size_t>(keep)) order.resize(keep);
+
+    MoveList sorted(moves.get_allocator());
+    sorted.reserve(order.size());
+    for (size_t i : order) sorted.push_back(moves[i]);
+    moves.swap(sorted);
+    if (ranked) {
+        ranked->clear();
+        for (size_t i : order) ranked->push_back({ score[i], static_cast<std::uint32_t>(i) });
+    }
+}
+
+void Searcher::reorder(TreeNode& node, std::uint64_t key) {
+    TTData entry;
+    std::uint32_t ttMove = table.probe(key, entry) ? entry.move : 0;
+    auto priority = [&](const Edge& e) { return e.score + (ttMove && moveId(e.move) == ttMove ? TT_MOVE_BONUS : 0); };
+    std::sort(node.edges, node.edges + node.count, [&](const Edge& a, const Edge& b) {
+        int pa = priority(a), pb = priority(b);
+        return pa != pb ? pa > pb : a.order < b.order;
+    });
+}
+
+// The board hash and the player to move, plus the hand: a node's move list
+// is only valid for the tiles it was generated from
+std::uint64_t Searcher::nodeKey(const GameState& state) {
+    std::uint64_t key = state.board.getHash() ^ zobrist::mix(static_cast<std::uint64_t>(state.currentPlayer) + 1);
+    std::uint64_t hand = 0;
+    for (const auto& slot : state.hand()) {
+        if (slot) hand += zobrist::mix(static_cast<std::uint64_t>(tileIndex(*slot) + 1) << 8);
+    }
+    return key ^ zobrist::mix(hand);
+}
+
+Searcher::TreeNode* Searcher::makeNode(std::uint64_t key, int keep, const MoveList& moves, const std::vector<Ranked>& ranked) {
+    Arena& arena = trees[activeTree];
+    TreeNode* node = arena.create<TreeNode>();
+    Edge* edges = arena.allocateArray<Edge>(moves.size());
+    if (!node || !edges) return nullptr;
+    for (size_t i = 0; i < moves.size(); ++i) edges[i] = Edge{ moves[i], ranked[i].score, ranked[i].order, nullptr };
+    *node = TreeNode{ key, keep, false, static_cast<std::uint32_t>(moves.size()), edges };
+    return node;
+}
+
+Searcher::TreeNode* Searcher::makePassNode(std::uint64_t key) {
+    Arena& arena = trees[activeTree];
+    TreeNode* node = arena.create<TreeNode>();
+    Edge* edge = arena.create<Edge>();
+    if (!node || !edge) return nullptr;
+    *edge = Edge{ Move{}, 0, 0, nullptr };
+    *node = TreeNode{ key, 0, true, 1, edge };
+    return node;
+}
+
+Searcher::TreeNode* Searcher::copyTree(const TreeNode& node, Arena& into) {
+    TreeNode* copy = into.create<TreeNode>(node);
+    Edge* edges = into.allocateArray<Edge>(node.count);
+    if (!copy || !edges) return nullptr;
+    copy->edges = edges;
+    for (std::uint32_t i = 0; i < node.count; ++i) {
+        edges[i] = node.edges[i];
+        // Past the cap the rest of the subtree is dropped; it is rebuilt when searched
+        if (node.edges[i].child) edges[i].child = copyTree(*node.edges[i].child, into);
+    }
+    return copy;
+}
+
+void Searcher::advanceRoot(const GameState& state, std::size_t capBytes) {
+    // Shallowest node for the new position, if the old tree reached it
+    std::uint64_t key = nodeKey(state);
+    TreeNode* found = nullptr;
+    std::vector<TreeNode*> level, next;
+    if (root) level.push_back(root);
+    while (!found && !level.empty()) {
+        next.clear();
+        for (TreeNode* node : level) {
+            if (node->key == key) {
+                found = node;
+                break;
+            }
+            for (std::uint32_t i = 0; i < node->count; ++i) {
+                if (node->edges[i].child) next.push_back(node->edges[i].child);
+            }
+        }
+        level.swap(next);
+    }
+
+    if (capBytes == 0) {
+        for (Arena& arena : trees) arena.release();
+        root = nullptr;
+        return;
+    }
+    Arena& spare = trees[1 - activeTree];
+    for (Arena& arena : trees) {
+        if (arena.bytesReserved() > capBytes / 2) arena.release();
+        arena.setCap(capBytes / 2);
+    }
+    spare.reset();
+    root = found ? copyTree(*found, spare) : nullptr;
+    trees[activeTree].reset();
+    activeTree = 1 - activeTree;
+}
+
+int Searcher::alphaBeta(const GameState& state, TreeNode** slot, int depth, int alpha, int beta, int ply) {
+    ++nodes;
+    if (state.isGameOver()) return evaluate(state);
+    if (depth == 0) {
+        reachedHorizon = true;
+        return evaluate(state);
+    }
+    if (shouldStop()) return 0;
+
+    std::uint64_t key = state.board.getHash() ^ zobrist::mix(static_cast<std::uint64_t>(state.currentPlayer) + 1);
+    std::uint64_t stateKey = slot ? nodeKey(state) : 0;
+    TreeNode* node = slot ? *slot : nullptr;
+    if (node && (node->key != stateKey || node->width != width)) node = nullptr;
+    PlyScratch& s = *scratch[ply];
+    MoveList& moves = s.moves;
+    if (!node) {
+        // Generation can take milliseconds for hands with many orderings, so
+        // it polls too. The last list is dropped before its arena is rewound.
+        MoveList(&s.genResource).swap(moves);
+        s.genArena.reset();
+        if (!movegen::generateMoves(state.board, state.hand(), moves, stopCheck)) return 0;
+        if (moves.empty()) {
+            if (slot) *slot = node = makePassNode(stateKey);
+        } else {
+            orderMoves(state, moves, key, width, &s.ranked);
+            // A list cut short by a stop is not kept
+            if (slot && !stopFlag.load(std::memory_order_relaxed)) *slot = node = makeNode(stateKey, width, moves, s.ranked);
+        }
+    } else if (!node->pass) {
+        reorder(*node, key);
+    }
+    if (node ? node->pass : moves.empty()) {
+        GameState child = branch(state, ply);
+        child.applyMove(Move{});
+        return alphaBeta(child, node ? &node->edges[0].child : nullptr, depth - 1, alpha, beta, ply + 1);
+    }
+    size_t count = node ? node->count : moves.size();
+    auto moveAt = [&](size_t i) -> const Move& { return node ? node->edges[i].move : moves[i]; };
+
+    bool maximizing = state.currentPlayer == rootPlayer;
+    int bestValue = maximizing ? -INF : INF;
+    size_t bestIndex = 0;
+    int alphaIn = alpha, betaIn = beta;
+    for (size_t i = 0; i < count; ++i) {
+        if (shouldStop(i == 0)) return 0; // ordering a long list takes a while
+        GameState child = branch(state, ply);
+        child.applyMove(moveAt(i));
+        int value = alphaBeta(child, node ? &node->edges[i].child : nullptr, depth - 1, alpha, beta, ply + 1);
+        if (stopFlag.load(std::memory_order_relaxed)) return 0;
+        if (maximizing ? value > bestValue : value < bestValue) {
+            bestValue = value;
+            bestIndex = i;
+        }
+        if (maximizing) alpha = std::max(alpha, value);
+        else beta = std::min(beta, value);
+        if (alpha >= beta) break;
+    }
+
+    // The table only orders moves: hands differ between states sharing a board
+    TTData d;
+    d.move = moveId(moveAt(bestIndex));
+    d.score = static_cast<std::int16_t>(std::clamp(bestValue, -32000, 32000));
+    d.depth = static_cast<std::uint8_t>(depth);
+    d.bound = bestValue <= alphaIn ? Bound::Upper : bestValue >= betaIn ? Bound::Lower : Bound::Exact;
+    table.store(key, d);
+    return bestValue;
+}
+
+SearchResult Searcher::search(const GameState& state, const SearchLimits& limits) {
+    Clock::time_point start = Clock::now();
+    stopFlag.store(false, std::memory_order_relaxed);
+    hasDeadline = limits.budgetMs > 0;
+    deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(limits.budgetMs));
+    pollCount = 0;
+    nodes = 0;
+    rootPlayer = state.currentPlayer;
+    width = std::max(1, limits.width);
+    while (scratch.size() < static_cast<size_t>(limits.maxDepth) + 1) scratch.push_back(std::make_unique<PlyScratch>());
+    table.newSearch();
+    advanceRoot(state, limits.treeBytes);
+
+    SearchResult result;
+    std::uint64_t rootKey = state.board.getHash() ^ zobrist::mix(static_cast<std::uint64_t>(rootPlayer) + 1);
+    MoveList rootMoves;
+    std::vector<TreeNode**> rootSlots; // parallel to rootMoves; null outside the tree
+    if (root && root->width == 0 && !root->pass) {
+        reorder(*root, rootKey);
+        for (std::uint32_t i = 0; i < root->count; ++i) {
+            rootMoves.push_back(root->edges[i].move);
+            rootSlots.push_back(&root->edges[i].child);
+        }
+    } else {
+        // The root polls too, but only once it has a move, so there is always
+        // something better than a pass to fall back on
+        std::function<bool()> rootStop = [&] { return !rootMoves.empty() && shouldStop(true); };
+        bool complete = movegen::generateMoves(state.board, state.hand(), rootMoves, rootStop);
+        orderMoves(state, rootMoves, rootKey, 0, &scratch[0]->ranked);
+        complete = complete && !stopFlag.load(std::memory_order_relaxed);
+        TreeNode* kept = root; // an inner node of the last tree: only its best moves
+        root = complete && limits.treeBytes > 0 && !rootMoves.empty()
+             ? makeNode(nodeKey(state), 0, rootMoves, scratch[0]->ranked) : nullptr;
+        for (std::uint32_t k = 0; root && kept && k < kept->count; ++k) {
+            const Edge& old = kept->edges[k];
+            for (std::uint32_t i = 0; i < root->count; ++i) {
+                if (sameMove(root->edges[i].move, old.move)) root->edges[i].child = old.child;
+            }
+        }
+        for (std::uint32_t i = 0; i < rootMoves.size(); ++i) rootSlots.push_back(root ? &root->edges[i].child : nullptr);
+    }
+    result.best = rootMoves.empty() ? Move{} : rootMoves.front(); // greedy fallback
+    publish(result.best);
+
+    for (int depth = 1; depth <= limits.maxDepth && rootMoves.size() > 1; ++depth) {
+        reachedHorizon = false;
+        int alpha = -INF;
+        int bestIndex = -1;
+        bool complete = true;
+        for (size_t i = 0; i < rootMoves.size(); ++i) {
+            if (shouldStop()) {
+                complete = false;
+                break;
+            }
+            GameState child = branch(state, 0);
+            child.applyMove(rootMoves[i]);
+            int value = alphaBeta(child, rootSlots[i], depth - 1, alpha, INF, 1);
+            if (stopFlag.load(std::memory_order_relaxed)) {
+                complete = false;
+                break;
+            }
+            if (value > alpha) {
+                alpha = value;
+                bestIndex = static_cast<int>(i);
+            }
+        }
+        // Searched moves were compared against the previous best, which is
+        // always tried first, so a partial iteration's best is still sound
+        if (bestIndex >= 0) {
+            result.best = rootMoves[bestIndex];
+            result.score = alpha;
+            publish(result.best);
+            std::rotate(rootMoves.begin(), rootMoves.begin() + bestIndex, rootMoves.begin() + bestIndex + 1);
+            std::rotate(rootSlots.begin(), rootSlots.begin() + bestIndex, rootSlots.begin() + bestIndex + 1);
+        }
+        if (!complete) break;
+        result.depth = depth;
+        if (!reachedHorizon) break; // every line ended the game; deeper changes nothing
+    }
+
+    result.nodes = nodes;
+    result.treeBytes = trees[0].bytesReserved() + trees[1].bytesReserved();
+    result.stopped = stopFlag.load(std::memory_order_relaxed);
+    result.elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,146 @@
+#pragma once
+#include "Arena.h"
+#include "GameState.h"
+#include "Move.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Limits for one search. The search stops at whichever comes first.
+struct SearchLimits {
+    double budgetMs = 0;     // wall-clock budget, 0 = none
+    int maxDepth = 64;       // plies
+    int width = 8;           // moves tried below the root, best immediate score first
+    std::size_t treeBytes = std::size_t(32) << 20; // cap on the kept search tree, 0 = keep none
+};
+
+struct SearchResult {
+    Move best;        // empty = pass
+    int score = 0;    // root player's margin at the horizon
+    int depth = 0;    // last fully searched depth
+    std::uint64_t nodes = 0;
+    double elapsedMs = 0;
+    bool stopped = false; // hit the budget or stop() before maxDepth
+    std::size_t treeBytes = 0; // held by the kept search tree afterwards
+};
+
+// Anytime alpha-beta bot. Iterative deepening over plies, maximising the
+// root player's score minus the best opponent's, with opponents assumed to
+// minimise it (paranoid). Below the root only the `width` best moves by
+// immediate score are searched. Hidden tiles (opponent hands, bag order) are
+// taken as known from the state.
+//
+// Greedy play is the fallback, so a best move exists before depth 1
+// finishes. Each completed iteration replaces it, as does a partial
+// iteration once its first root move (the previous best) has been searched.
+// Cancellation goes through an atomic flag: the search polls it at every
+// node, move and move-generation start cell, and compares against the
+// deadline every few polls. Another thread may call stop() or bestSoFar()
+// while search() runs.
+//
+// Child states are copied into a bump arena per ply that is rewound before
+// each sibling, so once warmed up the search makes no heap calls for boards.
+//
+// Searched nodes are kept in a tree of ordered, width-cut move lists, so
+// deeper iterations and later searches reuse them instead of generating
+// moves again (generation is most of a node's cost). The tree lives in a
+// bump arena. When the next search starts from a position in the tree, that
+// subtree is copied into the spare arena and the old one is reset, so memory
+// never holds more than the live tree. Both arenas share
+// SearchLimits::treeBytes. Nodes that don't fit are searched without being
+// kept. Each node records its position and the hand to move, and a node that
+// doesn't match the state reaching it is rebuilt.
+class Searcher {
+public:
+    explicit Searcher(std::size_t ttMegabytes = 16) : table(ttMegabytes) {}
+
+    SearchResult search(const GameState& state, const SearchLimits& limits);
+
+    void stop() { stopFlag.store(true, std::memory_order_relaxed); }
+    Move bestSoFar() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr unsigned CLOCK_CHECK_INTERVAL = 4; // polls between clock reads
+    static constexpr std::size_t TREE_BLOCK = std::size_t(256) << 10;
+
+    struct TreeNode;
+    struct Edge {
+        Move move;
+        std::int32_t score;  // immediate points, for reordering
+        std::uint32_t order; // generation index: ties keep it, as a stable sort would
+        TreeNode* child;     // null until searched
+    };
+    struct TreeNode {
+        std::uint64_t key;   // nodeKey() of its state
+        std::int32_t width;  // moves kept when it was built, 0 = all
+        bool pass;           // nothing was legal: one edge, the empty move
+        std::uint32_t count;
+        Edge* edges;
+    };
+    // Moves of a node as ordered by orderMoves(), with what a tree node keeps
+    struct Ranked {
+        std::int32_t score;
+        std::uint32_t order;
+    };
+
+    // `readClock` skips the poll interval, for polls between coarse steps
+    bool shouldStop(bool readClock = false);
+    // `slot` is where the state's tree node lives, null outside the tree
+    int alphaBeta(const GameState& state, TreeNode** slot, int depth, int alpha, int beta, int ply);
+    int evaluate(const GameState& state) const;
+    void orderMoves(const GameState& state, MoveList& moves, std::uint64_t key, int keep,
+                    std::vector<Ranked>* ranked = nullptr);
+    // Table move first, then by stored score and generation order
+    void reorder(TreeNode& node, std::uint64_t key);
+
+    static std::uint64_t nodeKey(const GameState& state);
+    // New node in the active tree arena; null once the cap is reached
+    TreeNode* makeNode(std::uint64_t key, int keep, const MoveList& moves, const std::vector<Ranked>& ranked);
+    TreeNode* makePassNode(std::uint64_t key);
+    // Keep only the subtree at `state`, compacted into the spare arena
+    void advanceRoot(const GameState& state, std::size_t capBytes);
+    TreeNode* copyTree(const TreeNode& node, Arena& into);
+    void publish(const Move& move);
+    // Copy of `state` to search below `ply`, in that ply's arena. Invalidates
+    // the previous child of the same ply.
+    GameState branch(const GameState& state, int ply);
+
+    TranspositionTable table;
+    std::atomic<bool> stopFlag{false};
+    std::function<bool()> stopCheck{ [this] { return shouldStop(true); } };
+    Clock::time_point deadline;
+    bool hasDeadline = false;
+    unsigned pollCount = 0;
+    std::uint64_t nodes = 0;
+    bool reachedHorizon = false; // some line was cut by depth, not the game end
+    int rootPlayer = 0;
+    int width = 8;
+
+    static constexpr std::size_t SCRATCH_BLOCK = std::size_t(64) << 10; // a few boards
+    struct PlyScratch {
+        Arena arena{Arena::NO_CAP, SCRATCH_BLOCK};
+        ArenaResource resource{arena};
+        // The ply's move list and the generator's start cells, rewound
+        // before each generation
+        Arena genArena{Arena::NO_CAP, SCRATCH_BLOCK};
+        ArenaResource genResource{genArena};
+        MoveList moves{&genResource};
+        std::vector<Ranked> ranked;
+    };
+    std::vector<std::unique_ptr<PlyScratch>> scratch; // per ply, reused across searches
+    std::vector<int> orderScore, orderPriority;       // orderMoves() buffers
+    std::vector<std::size_t> orderIndex;
+
+    Arena trees[2]{ Arena(Arena::NO_CAP, TREE_BLOCK), Arena(Arena::NO_CAP, TREE_BLOCK) };
+    int activeTree = 0;
+    TreeNode* root = nullptr;
+
+    mutable std::mutex bestMutex;
+    Move best;
+};
@@ -0,0 +1,27 @@
+#include "SelfPlay.h"
+#include "ThreadPool.h"
+
+namespace selfplay {
+
+int playGame(const Pairing& pairing) {
+    HeuristicBot bots[2] = { HeuristicBot(pairing.first), HeuristicBot(pairing.second) };
+    GameState state(2, pairing.seed);
+    state.board.trackLines();
+    state.deal();
+    int passes = 0;
+    while (!state.isGameOver() && passes < state.playerCount()) {
+        Move m = bots[state.currentPlayer].choose(state);
+        passes = m.empty() ? passes + 1 : 0;
+        state.applyMove(m);
+    }
+    return state.scores[0] - state.scores[1];
+}
+
+std::vector<int> playAll(const std::vector<Pairing>& pairings, int threads) {
+    std::vector<int> margins(pairings.size());
+    ThreadPool::shared().parallelFor(0, pairings.size(), [&](size_t i) { margins[i] = playGame(pairings[i]); },
+                                     TaskPriority::Background, threads);
+    return margins;
+}
+
+} // namespace selfplay
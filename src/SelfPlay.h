@@ -0,0 +1,24 @@
+#pragma once
+#include "HeuristicBot.h"
+#include <cstdint>
+#include <vector>
+
+// Parallel self-play between heuristic bots, for tuning and comparisons.
+namespace selfplay {
+
+// Two-player game dealt from `seed`; `first` sits in seat 0
+struct Pairing {
+    std::uint32_t seed;
+    EvalWeights first;
+    EvalWeights second;
+};
+
+// Final score of seat 0 minus seat 1
+int playGame(const Pairing& pairing);
+
+// Plays every pairing as background work on the shared thread pool, on at
+// most `threads` workers (0 = all); margins come back in pairing order, so
+// results don't depend on scheduling
+std::vector<int> playAll(const std::vector<Pairing>& pairings, int threads = 0);
+
+} // namespace selfplay
@@ -0,0 +1,158 @@
+#include "Solver.h"
+#include "MoveGen.h"
+#include "Rules.h"
+#include "ThreadPool.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+namespace solver {
+
+namespace {
+
+constexpr std::uint32_t NO_STEP = UINT32_MAX;
+
+// Moves on the path to a beam state, shared between states as a tree
+struct Step {
+    std::uint32_t parent;
+    Move move;
+};
+
+struct BeamState {
+    GameState state;
+    std::uint32_t step; // last move played, NO_STEP at the root
+};
+
+struct Candidate {
+    std::uint64_t hash;
+    int score;
+    std::uint32_t parent; // index into the current beam
+    Move move;
+};
+
+// Higher score first; the hash breaks ties so runs are reproducible
+bool better(const Candidate& a, const Candidate& b) {
+    return a.score != b.score ? a.score > b.score : a.hash < b.hash;
+}
+
+// Keep only the best `width` candidates
+void prune(std::vector<Candidate>& cands, size_t width) {
+    if (cands.size() <= width) return;
+    std::nth_element(cands.begin(), cands.begin() + width, cands.end(), better);
+    cands.resize(width);
+}
+
+} // namespace
+
+Solution solveSolitaire(const GameState& start, const BeamOptions& options) {
+    Solution best;
+    best.score = start.scores[start.currentPlayer];
+    size_t width = static_cast<size_t>(std::max(1, options.width));
+    ThreadPool& pool = ThreadPool::shared();
+
+    TranspositionTable seen(options.tableMegabytes);
+    std::vector<Step> steps;
+    std::uint32_t bestStep = NO_STEP;
+    std::vector<BeamState> beam{ BeamState{ start, NO_STEP } };
+
+    std::mutex bestMutex;
+    std::atomic<std::uint64_t> expanded{0}, duplicates{0};
+
+    while (!beam.empty()) {
+        // Expand: each worker claims beam states and gathers their children
+        std::vector<std::vector<Candidate>> local(pool.size());
+        std::vector<MoveList> moveLists(pool.size());
+        pool.parallelFor(0, beam.size(), [&](size_t i) {
+            std::vector<Candidate>& out = local[pool.workerIndex()];
+            MoveList& moves = moveLists[pool.workerIndex()];
+            const GameState& s = beam[i].state;
+            int score = s.scores[s.currentPlayer];
+            moves.clear();
+            if (!s.isGameOver()) movegen::generateMoves(s.board, s.hand(), moves);
+            expanded.fetch_add(1, std::memory_order_relaxed);
+            if (moves.empty()) {
+                std::lock_guard<std::mutex> lock(bestMutex);
+                if (score > best.score || (score == best.score && beam[i].step < bestStep)) {
+                    best.score = score;
+                    bestStep = beam[i].step;
+                }
+                return;
+            }
+            std::uint8_t tiles = static_cast<std::uint8_t>(std::min<size_t>(s.board.getTiles().size(), 255));
+            for (const Move& m : moves) {
+                std::uint64_t hash = s.board.getHash();
+                for (const Placement& p : m) hash ^= zobrist::key(p.pos.first, p.pos.second, p.tile);
+                int childScore = score + rules::scoreMove(s.board, m);
+
+                TTData known;
+                if (seen.probe(hash, known) && known.score >= childScore) {
+                    duplicates.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                TTData d;
+                d.score = static_cast<std::int16_t>(childScore);
+                d.depth = tiles;
+                d.bound = Bound::Exact;
+                seen.store(hash, d);
+
+                out.push_back(Candidate{ hash, childScore, static_cast<std::uint32_t>(i), m });
+                if (out.size() >= 4 * width) prune(out, width);
+            }
+        }, TaskPriority::Background, options.threads);
+
+        // Merge: one candidate per board, then the best `width` of those
+        std::vector<Candidate> cands;
+        for (auto& l : local) cands.insert(cands.end(), l.begin(), l.end());
+        std::sort(cands.begin(), cands.end(), [](const Candidate& a, const Candidate& b) {
+            return a.hash != b.hash ? a.hash < b.hash : a.score > b.score;
+        });
+        cands.erase(std::unique(cands.begin(), cands.end(),
+                                [](const Candidate& a, const Candidate& b) { return a.hash == b.hash; }),
+                    cands.end());
+        prune(cands, width);
+        std::sort(cands.begin(), cands.end(), better);
+
+        // Materialise the next beam
+        std::vector<BeamState> nextBeam;
+        nextBeam.reserve(cands.size());
+        for (const Candidate& c : cands) {
+            steps.push_back(Step{ beam[c.parent].step, c.move });
+            nextBeam.push_back(BeamState{ beam[c.parent].state, static_cast<std::uint32_t>(steps.size() - 1) });
+        }
+        pool.parallelFor(0, nextBeam.size(), [&](size_t i) { nextBeam[i].state.applyMove(cands[i].move); },
+                         TaskPriority::Background, options.threads);
+        beam = std::move(nextBeam);
+    }
+
+    for (std::uint32_t s = bestStep; s != NO_STEP; s = steps[s].parent) best.moves.push_back(steps[s].move);
+    std::reverse(best.moves.begin(), best.moves.end());
+    best.expanded = expanded;
+    best.duplicates = duplicates;
+    return best;
+}
+
+bool findPuzzle(const GameState& state, int minScore, int minGap, Puzzle& out) {
+    MoveList moves;
+    movegen::generateMoves(state.board, state.hand(), moves);
+    int bestScore = -1, second = 0;
+    const Move* bestMove = nullptr;
+    for (const Move& m : moves) {
+        int score = rules::scoreMove(state.board, m);
+        if (score > bestScore) {
+            second = std::max(second, bestScore);
+            bestScore = score;
+            bestMove = &m;
+        } else {
+            second = std::max(second, score);
+        }
+    }
+    if (!bestMove || bestScore < minScore || bestScore - second < minGap) return false;
+    out.answer = *bestMove;
+    out.score = bestScore;
+    out.runnerUp = second;
+    return true;
+}
+
+} // namespace solver
@@ -0,0 +1,39 @@
+#pragma once
+#include "GameState.h"
+#include "Move.h"
+#include <cstdint>
+#include <vector>
+
+// Solitaire puzzles: one player, a fixed bag order, maximise the total score.
+namespace solver {
+
+struct BeamOptions {
+    int width = 512;  // states kept per ply
+    int threads = 0;  // most shared-pool workers to use, 0 = all
+    std::size_t tableMegabytes = 64;
+};
+
+struct Solution {
+    int score = 0;
+    std::vector<Move> moves;
+    std::uint64_t expanded = 0;   // states whose moves were generated
+    std::uint64_t duplicates = 0; // children dropped as already-seen boards
+};
+
+// Beam search over a single-player game. With the bag order fixed, the board
+// alone determines which tiles have been drawn, so states are deduplicated by
+// board hash, keeping the higher score. Pool workers expand beam states in
+// parallel and share a transposition table for the dedupe; the best `width`
+// children of each ply form the next beam. Ends when no state can move.
+Solution solveSolitaire(const GameState& start, const BeamOptions& options = {});
+
+// "Find the N-point move": the side to move's best move scores at least
+// `minScore` and beats every other move by at least `minGap`.
+struct Puzzle {
+    Move answer;
+    int score = 0;
+    int runnerUp = 0;
+};
+bool findPuzzle(const GameState& state, int minScore, int minGap, Puzzle& out);
+
+} // namespace solver
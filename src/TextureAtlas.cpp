@@ -0,0 +1,79 @@
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+
+const char SHAPE_NAMES[] = { 'O', 'S', 'D', 'F', 'C', 'A' }; // by Shape value
+const char COLOR_NAMES[] = { 'r', 'o', 'y', 'g', 'b', 'p' }; // by Color value
+
+// Copies `src` into the atlas cell at (cx, cy), averaging down to CELL pixels
+void blit(sf::Image& atlas, const sf::Image& src, unsigned cx, unsigned cy) {
+    const unsigned cell = TextureAtlas::CELL;
+    sf::Vector2u size = src.getSize();
+    unsigned fx = std::max(1u, size.x / cell), fy = std::max(1u, size.y / cell);
+    for (unsigned y = 0; y < cell; ++y) {
+        for (unsigned x = 0; x < cell; ++x) {
+            unsigned sum[4] = {};
+            unsigned x0 = x * size.x / cell, y0 = y * size.y / cell;
+            for (unsigned dy = 0; dy < fy; ++dy) {
+                for (unsigned dx = 0; dx < fx; ++dx) {
+                    sf::Color c = src.getPixel(std::min(x0 + dx, size.x - 1), std::min(y0 + dy, size.y - 1));
+                    sum[0] += c.r;
+                    sum[1] += c.g;
+                    sum[2] += c.b;
+                    sum[3] += c.a;
+                }
+            }
+            unsigned n = fx * fy;
+            atlas.setPixel(cx * cell + x, cy * cell + y,
+                           sf::Color(static_cast<sf::Uint8>(sum[0] / n), static_cast<sf::Uint8>(sum[1] / n),
+                                     static_cast<sf::Uint8>(sum[2] / n), static_cast<sf::Uint8>(sum[3] / n)));
+        }
+    }
+}
+
+} // namespace
+
+std::string TextureAtlas::tileFilename(Shape s, Color c, const std::string& assetsDir) {
+    std::string name = { COLOR_NAMES[static_cast<int>(c)], SHAPE_NAMES[static_cast<int>(s)] };
+    name += ".png";
+    if (assetsDir.empty()) return name;
+    return assetsDir.back() == '/' ? assetsDir + name : assetsDir + "/" + name;
+}
+
+bool TextureAtlas::load(const std::string& assetsDir) {
+    sf::Image image;
+    image.create(6 * CELL, 6 * CELL, sf::Color::Transparent);
+    int loaded = 0;
+    for (int i = 0; i < TILE_KINDS; ++i) {
+        Tile t = tileFromIndex(i);
+        sf::Image tile;
+        if (!tile.loadFromFile(tileFilename(t.shape, t.color, assetsDir))) continue;
+        blit(image, tile, static_cast<unsigned>(t.shape), static_cast<unsigned>(t.color));
+        ++loaded;
+    }
+    if (loaded == 0) {
+        std::cerr << "Error: no tile images loaded from '" << assetsDir << "'.\n";
+        return false;
+    }
+    if (!atlas.loadFromImage(image)) return false;
+    atlas.setSmooth(true);
+    atlas.generateMipmap(); // boards in a grid are drawn far below CELL size
+    return true;
+}
+
+sf::FloatRect TextureAtlas::rectFor(const Tile& tile) const {
+    return sf::FloatRect(static_cast<float>(static_cast<unsigned>(tile.shape) * CELL),
+                         static_cast<float>(static_cast<unsigned>(tile.color) * CELL),
+                         static_cast<float>(CELL), static_cast<float>(CELL));
+}
+
+void TextureAtlas::writeQuad(sf::Vertex* quad, int x, int y, const Tile& tile) const {
+    sf::FloatRect tex = rectFor(tile);
+    float fx = static_cast<float>(x), fy = static_cast<float>(y);
+    quad[0] = sf::Vertex(sf::Vector2f(fx, fy), sf::Vector2f(tex.left, tex.top));
+    quad[1] = sf::Vertex(sf::Vector2f(fx + 1, fy), sf::Vector2f(tex.left + tex.width, tex.top));
+    quad[2] = sf::Vertex(sf::Vector2f(fx + 1, fy + 1), sf::Vector2f(tex.left + tex.width, tex.top + tex.height));
+    quad[3] = sf::Vertex(sf::Vector2f(fx, fy + 1), sf::Vector2f(tex.left, tex.top + tex.height));
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "Tile.h"
+#include <SFML/Graphics.hpp>
+#include <string>
+
+// All 36 tile images packed into one texture (a 6x6 grid, color rows, shape
+// columns), so any number of tiles can be drawn from a single vertex array
+// in one draw call.
+class TextureAtlas {
+public:
+    static constexpr unsigned CELL = 128; // pixels per tile image in the atlas
+
+    // Loads every tile image from `assetsDir`; missing ones stay transparent.
+    // False if none loaded.
+    bool load(const std::string& assetsDir);
+
+    const sf::Texture& texture() const { return atlas; }
+    // Texture coordinates of a tile's image
+    sf::FloatRect rectFor(const Tile& tile) const;
+    // The four vertices (sf::Quads) of a tile covering the unit square at
+    // board cell (x, y)
+    void writeQuad(sf::Vertex* quad, int x, int y, const Tile& tile) const;
+
+    // Image file of one tile kind, e.g. assetsDir/rO.png
+    static std::string tileFilename(Shape s, Color c, const std::string& assetsDir);
+
+private:
+    sf::Texture atlas;
+};
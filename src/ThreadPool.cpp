@@ -0,0 +1,181 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+
+thread_local const ThreadPool* currentPool = nullptr;
+thread_local int currentIndex = -1;
+
+std::mutex sharedMutex;
+std::unique_ptr<ThreadPool> sharedPool;
+
+void pinToCpu(std::thread& thread, int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#else
+    (void)thread;
+    (void)cpu;
+#endif
+}
+
+// One parallelFor call. Held by every task working on it, so a task that
+// starts after the loop has returned only finds it exhausted.
+struct Loop {
+    std::atomic<std::size_t> next;
+    std::size_t end;
+    std::size_t count;
+    const std::function<void(std::size_t)>* fn;
+    TaskPriority priority;
+    std::atomic<std::size_t> done{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+void work(ThreadPool& pool, const std::shared_ptr<Loop>& loop) {
+    for (std::size_t i; (i = loop->next.fetch_add(1)) < loop->end;) {
+        (*loop->fn)(i);
+        if (loop->done.fetch_add(1) + 1 == loop->count) {
+            std::lock_guard<std::mutex> lock(loop->mutex);
+            loop->finished.notify_all();
+        }
+        // Hand the worker to interactive work; the rest of the loop goes
+        // back on the queue behind it
+        if (loop->priority == TaskPriority::Background && pool.interactiveWaiting()) {
+            pool.submit([&pool, loop] { work(pool, loop); }, TaskPriority::Background);
+            return;
+        }
+    }
+}
+
+} // namespace
+
+ThreadPool::ThreadPool(int threads, bool pin) {
+    int cpus = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    if (threads <= 0) threads = cpus;
+    for (int i = 0; i < threads; ++i) workers.push_back(std::make_unique<Worker>());
+    for (int i = 0; i < threads; ++i) {
+        workers[i]->thread = std::thread(&ThreadPool::run, this, i);
+        if (pin) pinToCpu(workers[i]->thread, i % cpus);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& w : workers) w->thread.join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (!sharedPool) sharedPool = std::make_unique<ThreadPool>();
+    return *sharedPool;
+}
+
+bool ThreadPool::configureShared(int threads, bool pin) {
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (sharedPool) return false;
+    sharedPool = std::make_unique<ThreadPool>(threads, pin);
+    return true;
+}
+
+int ThreadPool::workerIndex() const {
+    return currentPool == this ? currentIndex : -1;
+}
+
+void ThreadPool::submit(std::function<void()> task, TaskPriority priority) {
+    int p = static_cast<int>(priority);
+    // Workers push onto their own deque; other threads spread round-robin
+    int self = workerIndex();
+    Worker& w = *workers[self >= 0 ? self : nextQueue.fetch_add(1) % workers.size()];
+    {
+        std::lock_guard<std::mutex> lock(w.mutex);
+        w.tasks[p].push_back(std::move(task));
+    }
+    queued[p].fetch_add(1);
+    std::lock_guard<std::mutex> lock(sleepMutex);
+    wake.notify_one();
+}
+
+bool ThreadPool::take(int self, std::function<void()>& task) {
+    int n = size();
+    for (int p = 0; p < PRIORITIES; ++p) {
+        if (queued[p].load() == 0) continue;
+        // Own deque newest first, then the others' oldest
+        if (self >= 0) {
+            Worker& w = *workers[self];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.tasks[p].empty()) {
+                task = std::move(w.tasks[p].back());
+                w.tasks[p].pop_back();
+                queued[p].fetch_sub(1);
+                return true;
+            }
+        }
+        int start = self >= 0 ? self + 1 : 0;
+        for (int k = 0; k < n; ++k) {
+            Worker& w = *workers[(start + k) % n];
+            std::lock_guard<std::mutex> lock(w.mutex);
+            if (!w.tasks[p].empty()) {
+                task = std::move(w.tasks[p].front());
+                w.tasks[p].pop_front();
+                queued[p].fetch_sub(1);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::runOne(int self) {
+    std::function<void()> task;
+    if (!take(self, task)) return false;
+    task();
+    return true;
+}
+
+void ThreadPool::run(int index) {
+    currentPool = this;
+    currentIndex = index;
+    for (;;) {
+        if (runOne(index)) continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wake.wait(lock, [&] { return stopping || queued[0].load() + queued[1].load() > 0; });
+        if (stopping && queued[0].load() + queued[1].load() == 0) return;
+    }
+}
+
+void ThreadPool::parallelFor(std::size_t begin, std::size_t end, const std::function<void(std::size_t)>& fn,
+                             TaskPriority priority, int maxTasks) {
+    if (begin >= end) return;
+    auto loop = std::make_shared<Loop>();
+    loop->next = begin;
+    loop->end = end;
+    loop->count = end - begin;
+    loop->fn = &fn;
+    loop->priority = priority;
+
+    int tasks = maxTasks > 0 ? std::min(maxTasks, size()) : size();
+    tasks = static_cast<int>(std::min<std::size_t>(tasks, loop->count));
+    for (int t = 0; t < tasks; ++t) submit([this, loop] { work(*this, loop); }, priority);
+
+    // A worker can't block here: the tasks may be queued behind it
+    int self = workerIndex();
+    if (self >= 0) {
+        while (loop->done.load() < loop->count) {
+            if (!runOne(self)) std::this_thread::yield();
+        }
+        return;
+    }
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->finished.wait(lock, [&] { return loop->done.load() == loop->count; });
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Interactive work (a bot thinking for the GUI) runs before any queued
+// background work (self-play, analysis, index builds)
+enum class TaskPriority { Interactive, Background };
+
+// Work-stealing thread pool shared by the engine's parallel jobs. Every
+// worker keeps a deque per priority: it takes its own newest task first and
+// steals the oldest from the others when it runs dry. Background loops in
+// parallelFor give their worker back between items whenever interactive work
+// is queued, so a search never waits for a batch of games to finish.
+class ThreadPool {
+public:
+    // 0 threads = hardware concurrency; `pin` binds worker i to CPU i where
+    // the platform allows it
+    explicit ThreadPool(int threads = 0, bool pin = false);
+    // Runs what is queued, then joins the workers
+    ~ThreadPool();
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // The pool the engine uses, created on first use
+    static ThreadPool& shared();
+    // Sets up the shared pool; false if it already exists
+    static bool configureShared(int threads, bool pin = false);
+
+    // Queue a task; callable from any thread, including pool workers
+    void submit(std::function<void()> task, TaskPriority priority = TaskPriority::Background);
+
+    // Calls fn(i) for every i in [begin, end) on at most `maxTasks` workers
+    // (0 = all of them) and returns when all calls are done. Items are
+    // claimed one at a time, so uneven items balance themselves. A worker
+    // calling this helps run queued tasks while it waits, so loops nest.
+    void parallelFor(std::size_t begin, std::size_t end, const std::function<void(std::size_t)>& fn,
+                     TaskPriority priority = TaskPriority::Background, int maxTasks = 0);
+
+    int size() const { return static_cast<int>(workers.size()); }
+    // Index of the calling worker in [0, size()), or -1 off the pool
+    int workerIndex() const;
+    // True while interactive tasks wait; long background tasks can poll it
+    // and yield
+    bool interactiveWaiting() const { return queued[0].load(std::memory_order_relaxed) > 0; }
+
+private:
+    static constexpr int PRIORITIES = 2;
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks[PRIORITIES];
+        std::thread thread;
+    };
+
+    void run(int index);
+    // Pops or steals the most urgent task; `self` is -1 off the pool
+    bool take(int self, std::function<void()>& task);
+    // Runs one queued task if there is one
+    bool runOne(int self);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<unsigned> nextQueue{0};            // round-robin for outside submits
+    std::atomic<int> queued[PRIORITIES] = {{0}, {0}};
+    std::mutex sleepMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
@@ -1,10 +1,29 @@
 #pragma once
-#include <SFML/Graphics.hpp>
+#include <cstdint>
 
-enum class Shape { Circle, Square, Diamond, Fourpoint, Clover, Astericks };
-enum class Color { Red, Orange, Yellow, Green, Blue, Purple };
+enum class Shape : std::uint8_t { Circle, Square, Diamond, Fourpoint, Clover, Astericks };
+enum class Color : std::uint8_t { Red, Orange, Yellow, Green, Blue, Purple };
 
 struct Tile {
     Shape shape;
     Color color;
-};
\ No newline at end of file
+};
+
+// Dense 0..35 index for a tile kind (color-major), used for hashing and tables
+constexpr int TILE_KINDS = 36;
+
+inline int tileIndex(const Tile& t) {
+    return static_cast<int>(t.color) * 6 + static_cast<int>(t.shape);
+}
+
+inline Tile tileFromIndex(int index) {
+    return Tile{ static_cast<Shape>(index % 6), static_cast<Color>(index / 6) };
+}
+
+inline bool operator==(const Tile& a, const Tile& b) {
+    return a.shape == b.shape && a.color == b.color;
+}
+
+inline bool operator!=(const Tile& a, const Tile& b) {
+    return !(a == b);
+}
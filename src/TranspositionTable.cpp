@@ -0,0 +1,184 @@
+#include "TranspositionTable.h"
+#include <new>
+
+#if defined(__linux__)
+#include <fstream>
+#include <string>
+#include <sys/mman.h>
+
+namespace {
+
+// Default huge page size from /proc/meminfo ("Hugepagesize: 2048 kB")
+std::size_t hugePageSize() {
+    std::ifstream meminfo("/proc/meminfo");
+    std::string key;
+    std::size_t kb = 0;
+    while (meminfo >> key) {
+        if (key == "Hugepagesize:" && meminfo >> kb) return kb * 1024;
+        meminfo.ignore(256, '\n');
+    }
+    return std::size_t(2) << 20;
+}
+
+} // namespace
+#endif
+
+// Packed layout: move[0..31] score[32..47] depth[48..55] bound[56..57] age[58..63]
+std::uint64_t TranspositionTable::pack(const TTData& d, std::uint8_t age) {
+    return static_cast<std::uint64_t>(d.move)
+         | static_cast<std::uint64_t>(static_cast<std::uint16_t>(d.score)) << 32
+         | static_cast<std::uint64_t>(d.depth) << 48
+         | static_cast<std::uint64_t>(static_cast<std::uint8_t>(d.bound) & 0x3) << 56
+         | static_cast<std::uint64_t>(age & AGE_MASK) << 58;
+}
+
+TTData TranspositionTable::unpack(std::uint64_t packed) {
+    TTData d;
+    d.move = static_cast<std::uint32_t>(packed);
+    d.score = static_cast<std::int16_t>(static_cast<std::uint16_t>(packed >> 32));
+    d.depth = static_cast<std::uint8_t>(packed >> 48);
+    d.bound = static_cast<Bound>((packed >> 56) & 0x3);
+    return d;
+}
+
+TranspositionTable::TranspositionTable(std::size_t megabytes) {
+    std::size_t budget = megabytes * 1024 * 1024;
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= budget) count *= 2;
+    bucketMask = count - 1;
+    std::size_t bytes = count * sizeof(Bucket);
+
+    void* mem = nullptr;
+#if defined(__linux__)
+    // Prefer explicit huge pages, then transparent huge pages, then plain pages
+#if defined(MAP_HUGETLB)
+    // The length of a hugetlb mapping (and so of its munmap) must be a
+    // multiple of the huge page size; the slack past the table is unused
+    std::size_t hugePage = hugePageSize();
+    std::size_t hugeBytes = (bytes + hugePage - 1) / hugePage * hugePage;
+    mem = mmap(nullptr, hugeBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mem != MAP_FAILED) {
+        pageKind = Pages::Huge;
+        mappedBytes = hugeBytes;
+    } else
+#endif
+    {
+        mem = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mem == MAP_FAILED) {
+            mem = nullptr;
+        }
+#if defined(MADV_HUGEPAGE)
+        else if (madvise(mem, bytes, MADV_HUGEPAGE) == 0) {
+            pageKind = Pages::TransparentRequested;
+        }
+#endif
+        if (mem) mappedBytes = bytes;
+    }
+#endif
+    if (!mem) {
+        mem = ::operator new(bytes, std::align_val_t(alignof(Bucket)));
+    }
+
+    buckets = static_cast<Bucket*>(mem);
+    for (std::size_t i = 0; i < count; ++i) {
+        new (&buckets[i]) Bucket();
+    }
+    clear();
+}
+
+const char* TranspositionTable::pagesName(Pages p) {
+    switch (p) {
+        case Pages::Huge: return "huge";
+        case Pages::TransparentRequested: return "THP requested";
+        case Pages::Normal: break;
+    }
+    return "normal";
+}
+
+TranspositionTable::~TranspositionTable() {
+    // Bucket is trivially destructible; only the storage needs releasing
+#if defined(__linux__)
+    if (mappedBytes) {
+        munmap(buckets, mappedBytes);
+        return;
+    }
+#endif
+    ::operator delete(buckets, std::align_val_t(alignof(Bucket)));
+}
+
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i <= bucketMask; ++i) {
+        for (Entry& e : buckets[i].entries) {
+            e.check.store(0, std::memory_order_relaxed);
+            e.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    age = 0;
+}
+
+bool TranspositionTable::probe(std::uint64_t hash, TTData& out) const {
+    const Bucket& bucket = buckets[static_cast<std::size_t>(hash) & bucketMask];
+    for (const Entry& e : bucket.entries) {
+        std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        std::uint64_t check = e.check.load(std::memory_order_relaxed);
+        if ((check ^ data) != hash) continue;
+        TTData d = unpack(data);
+        if (d.bound == Bound::None) continue; // never-written slot (hash 0 matches an empty entry)
+        out = d;
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t hash, const TTData& data) {
+    Bucket& bucket = buckets[static_cast<std::size_t>(hash) & bucketMask];
+
+    // Replace the same position if present, otherwise the entry with the
+    // lowest depth, penalising entries from older searches.
+    Entry* victim = nullptr;
+    int victimValue = 0;
+    std::uint64_t victimData = 0;
+    for (Entry& e : bucket.entries) {
+        std::uint64_t old = e.data.load(std::memory_order_relaxed);
+        std::uint64_t check = e.check.load(std::memory_order_relaxed);
+        TTData d = unpack(old);
+        if ((check ^ old) == hash && d.bound != Bound::None) {
+            victim = &e;
+            victimData = old;
+            break;
+        }
+        int staleness = (age - ageOf(old)) & AGE_MASK;
+        int value = d.bound == Bound::None ? -1024 : d.depth - 8 * staleness;
+        if (!victim || value < victimValue) {
+            victim = &e;
+            victimValue = value;
+            victimData = old;
+        }
+    }
+
+    TTData toStore = data;
+    if ((victim->check.load(std::memory_order_relaxed) ^ victimData) == hash) {
+        TTData existing = unpack(victimData);
+        // Keep a deeper result from this search unless the new one is exact
+        if (ageOf(victimData) == age && existing.depth > data.depth && data.bound != Bound::Exact) {
+            return;
+        }
+        if (toStore.move == 0) toStore.move = existing.move;
+    }
+
+    std::uint64_t packed = pack(toStore, age);
+    victim->data.store(packed, std::memory_order_relaxed);
+    victim->check.store(hash ^ packed, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const {
+    std::size_t sample = bucketCount() < 250 ? bucketCount() : 250;
+    int used = 0;
+    for (std::size_t i = 0; i < sample; ++i) {
+        for (const Entry& e : buckets[i].entries) {
+            std::uint64_t d = e.data.load(std::memory_order_relaxed);
+            if (unpack(d).bound != Bound::None && ageOf(d) == age) ++used;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sample * ENTRIES_PER_BUCKET));
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Kind of bound a stored search score represents
+enum class Bound : std::uint8_t { None, Exact, Lower, Upper };
+
+// Unpacked contents of a table entry
+struct TTData {
+    std::uint32_t move = 0; // caller-defined move id, 0 = none
+    std::int16_t score = 0;
+    std::uint8_t depth = 0;
+    Bound bound = Bound::None;
+};
+
+// Shared transposition table keyed by Board::getHash().
+//
+// Memory is split into cache-line sized buckets of four entries. Entries are
+// lockless: each stores its packed data and (hash ^ data), so a torn write
+// from two racing threads simply fails verification on probe instead of
+// returning another position's data. Any number of threads may probe/store
+// concurrently; newSearch() and clear() must not race with them.
+class TranspositionTable {
+public:
+    // Sized to the largest power-of-two bucket count fitting in the budget
+    explicit TranspositionTable(std::size_t megabytes);
+    ~TranspositionTable();
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    bool probe(std::uint64_t hash, TTData& out) const;
+    void store(std::uint64_t hash, const TTData& data);
+
+    // Start a new search: entries from older searches are replaced first
+    void newSearch() { age = static_cast<std::uint8_t>((age + 1) & AGE_MASK); }
+    void clear();
+
+    std::size_t bucketCount() const { return bucketMask + 1; }
+    std::size_t sizeBytes() const { return bucketCount() * sizeof(Bucket); }
+    // Explicit huge pages (MAP_HUGETLB) are known to be in use. Transparent
+    // huge pages can only be asked for: the kernel may still back the table
+    // with normal pages, so that case is reported as requested.
+    enum class Pages { Normal, TransparentRequested, Huge };
+    Pages pages() const { return pageKind; }
+    bool usesHugePages() const { return pageKind == Pages::Huge; }
+    static const char* pagesName(Pages p);
+
+    // Permille of sampled entries written during the current search
+    int hashfull() const;
+
+private:
+    static constexpr int ENTRIES_PER_BUCKET = 4;
+    static constexpr std::uint8_t AGE_MASK = 0x3F; // 6-bit generation counter
+
+    struct Entry {
+        std::atomic<std::uint64_t> check; // hash ^ data
+        std::atomic<std::uint64_t> data;
+    };
+    struct alignas(64) Bucket {
+        Entry entries[ENTRIES_PER_BUCKET];
+    };
+    static_assert(sizeof(Bucket) == 64, "bucket must fill exactly one cache line");
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "entries must be lock-free");
+
+    static std::uint64_t pack(const TTData& d, std::uint8_t age);
+    static TTData unpack(std::uint64_t packed);
+    static std::uint8_t ageOf(std::uint64_t packed) { return static_cast<std::uint8_t>(packed >> 58); }
+
+    Bucket* buckets = nullptr;
+    std::size_t bucketMask = 0;
+    std::size_t mappedBytes = 0; // non-zero when allocated through mmap
+    Pages pageKind = Pages::Normal;
+    std::uint8_t age = 0;
+};
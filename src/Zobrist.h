@@ -0,0 +1,25 @@
+#pragma once
+#include "Tile.h"
+#include <cstdint>
+
+// Zobrist-style keys for (cell, tile) pairs.
+// The board is unbounded, so instead of a lookup table the key is derived by
+// mixing the packed coordinate and tile index through splitmix64. XOR-ing the
+// keys of all placed tiles gives an order-independent position hash that can
+// be updated incrementally on every placement.
+namespace zobrist {
+
+inline std::uint64_t mix(std::uint64_t z) {
+    z += 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline std::uint64_t key(int x, int y, const Tile& tile) {
+    std::uint64_t packed = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32)
+                         | static_cast<std::uint32_t>(y);
+    return mix(packed * TILE_KINDS + static_cast<std::uint64_t>(tileIndex(tile)));
+}
+
+} // namespace zobrist
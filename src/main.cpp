@@ -1,7 +1,42 @@
 #include "Game.h"
+#include "GridView.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
 
-int main() {
+int main(int argc, char** argv) {
+    RunOptions options;
+    GridOptions grid;
+    bool watch = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--record" && hasValue) options.recordPath = argv[++i];
+        else if (arg == "--replay" && hasValue) options.replayPath = argv[++i];
+        else if (arg == "--stats" && hasValue) options.statsPath = grid.statsPath = argv[++i];
+        else if (arg == "--autosave-dir" && hasValue) options.autosaveDir = argv[++i];
+        else if (arg == "--no-autosave") options.autosaveDir.clear();
+        else if (arg == "--new") options.freshStart = true;
+        else if (arg == "--grid" && hasValue && std::sscanf(argv[++i], "%dx%d", &grid.columns, &grid.rows) == 2
+                 && grid.columns > 0 && grid.rows > 0) watch = true;
+        else if (arg == "--move-ms" && hasValue) grid.moveMillis = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue) grid.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else {
+            std::cerr << "usage: qwirkle [--record FILE | --replay FILE] [--stats FILE|-]\n"
+                         "               [--autosave-dir DIR | --no-autosave] [--new]\n"
+                         "       qwirkle --grid COLSxROWS [--move-ms N] [--seed S] [--stats FILE|-]\n";
+            return 1;
+        }
+    }
+
+    if (watch) {
+        GridView view(grid);
+        view.run();
+        return 0;
+    }
     Game game;
-    game.run();
+    game.run(options);
     return 0;
 }
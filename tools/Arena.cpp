@@ -0,0 +1,142 @@
+// Game hosting harness. Starts many games on a GameHost, each a coroutine
+// waiting for moves, then has simulated remote bots play a subset of them to
+// the end while the rest stay idle, as games waiting on humans would. It
+// reports the memory per idle game and the throughput of the active ones.
+// Threads are fixed (executor plus bots) no matter how many games there are.
+//
+// usage: qwirkle_arena [--games N] [--active A] [--threads T] [--bots B] [--seed S]
+#include "Executor.h"
+#include "GameHost.h"
+#include "HeuristicBot.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int games = 100000;
+    int active = 1000; // games the bots play; the rest wait forever
+    int threads = 0;   // executor workers, 0 = hardware concurrency
+    int bots = 1;      // remote bot threads
+    std::uint32_t seed = 1;
+};
+
+// Resident set size in bytes, 0 where unavailable
+long long residentBytes() {
+    std::ifstream statm("/proc/self/statm");
+    long long pages = 0, resident = 0;
+    if (!(statm >> pages >> resident)) return 0;
+    return resident * 4096;
+}
+
+// One remote bot: answers the requests routed to it, one at a time
+struct RemoteBot {
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<MoveRequest> requests;
+    bool stopping = false;
+
+    void push(const MoveRequest& r) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(r);
+        }
+        wake.notify_one();
+    }
+
+    void run(GameHost& host) {
+        HeuristicBot bot;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return stopping || !requests.empty(); });
+            if (requests.empty()) return;
+            MoveRequest r = requests.front();
+            requests.pop_front();
+            lock.unlock();
+            host.deliver(r.game, bot.choose(*r.state));
+            lock.lock();
+        }
+    }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) opt.games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--active" && hasValue) opt.active = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) opt.threads = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--bots" && hasValue) opt.bots = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue) opt.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else {
+            std::cerr << "usage: qwirkle_arena [--games N] [--active A] [--threads T] [--bots B] [--seed S]\n";
+            return 1;
+        }
+    }
+    opt.active = std::min(opt.active, opt.games);
+
+    std::vector<std::unique_ptr<RemoteBot>> bots;
+    for (int b = 0; b < opt.bots; ++b) bots.push_back(std::make_unique<RemoteBot>());
+    std::atomic<long long> requests{0};
+    auto route = [&](const MoveRequest& r) {
+        requests.fetch_add(1);
+        if (r.game >= opt.games - opt.active) bots[r.game % bots.size()]->push(r);
+    };
+
+    long long rssBefore = residentBytes();
+    Executor executor(opt.threads);
+    GameHost host(executor, route, opt.games);
+    std::vector<std::thread> botThreads;
+    for (auto& b : bots) botThreads.emplace_back([&host, &b] { b->run(host); });
+
+    // Idle games first: they are waiting for their first move once each has
+    // asked for it
+    int idle = opt.games - opt.active;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int g = 0; g < idle; ++g) host.addGame(opt.seed + g);
+    while (requests.load() < idle) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    double startSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    long long rssIdle = residentBytes();
+    std::printf("%d idle games started in %.2fs: %.0f bytes resident each, %d executor threads\n", idle, startSecs,
+                idle > 0 ? static_cast<double>(rssIdle - rssBefore) / idle : 0.0, executor.size());
+
+    // Then the active games, played to the end by the remote bots
+    t0 = std::chrono::steady_clock::now();
+    for (int g = idle; g < opt.games; ++g) host.addGame(opt.seed + g);
+    while (host.finishedCount() < opt.active) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    double playSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    long long scoreSum = 0;
+    for (int g = idle; g < opt.games; ++g) {
+        for (int s : host.result(g)) scoreSum += s;
+    }
+    std::printf("%d active games finished in %.2fs alongside them: %lld moves (%.0f/s), %lld rejected, "
+                "mean score %.1f per player\n", opt.active, playSecs, host.movesPlayed(),
+                host.movesPlayed() / std::max(playSecs, 1e-9), host.movesRejected(),
+                opt.active > 0 ? scoreSum / (2.0 * opt.active) : 0.0);
+
+    executor.stop();
+    for (auto& b : bots) {
+        {
+            std::lock_guard<std::mutex> lock(b->mutex);
+            b->stopping = true;
+        }
+        b->wake.notify_one();
+    }
+    for (auto& t : botThreads) t.join();
+    return 0;
+}
@@ -0,0 +1,144 @@
+// Expectimax bot harness. Plays seeded two-player games, expectimax bot
+// against the one-ply heuristic bot with seats swapped on every seed, and
+// reports the mean margin, time per move and chance node statistics.
+//
+// With --samples K, every chance node the bot enumerates at the root is also
+// estimated by Monte Carlo: K refills sampled from the same unseen tiles.
+// It then prints the RMS error of that estimate against the exact value, next
+// to the number of distinct refills the exact node needed.
+//
+// usage: qwirkle_expect [--games N] [--seed S] [--depth D] [--width W]
+//                       [--max-outcomes M] [--samples K]
+#include "Expectimax.h"
+#include "GameState.h"
+#include "HeuristicBot.h"
+#include "Rng.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int games = 20;
+    std::uint32_t seed = 1;
+    int depth = 1;
+    int width = 6;
+    int maxOutcomes = 256;
+    int samples = 0; // 0 = no Monte Carlo comparison
+};
+
+struct Comparison {
+    double squaredError = 0;
+    double outcomes = 0;
+    int nodes = 0;
+};
+
+// Refill `kept` with `draws` tiles taken at random from `pool`
+expectimax::KindCounts sampleRefill(const expectimax::KindCounts& pool, expectimax::KindCounts kept, int draws, Rng& rng) {
+    std::vector<int> tiles;
+    for (int k = 0; k < TILE_KINDS; ++k) tiles.insert(tiles.end(), pool[k], k);
+    draws = std::min<int>(draws, static_cast<int>(tiles.size()));
+    for (int i = 0; i < draws; ++i) {
+        std::swap(tiles[i], tiles[i + rng() % (tiles.size() - i)]);
+        ++kept[tiles[i]];
+    }
+    return kept;
+}
+
+// Compares the exact chance node after `move` with a K-sample estimate
+void compare(ExpectimaxBot& bot, const GameState& state, const Move& move, int samples, Rng& rng, Comparison& out) {
+    expectimax::KindCounts pool = expectimax::unseenTiles(state), kept{};
+    for (const auto& slot : state.hand()) {
+        if (slot) ++kept[tileIndex(*slot)];
+    }
+    for (const Placement& p : move) --kept[tileIndex(p.tile)];
+    int draws = std::min(move.size(), static_cast<int>(state.tileBag.size()));
+
+    std::vector<expectimax::Draw> outcomes;
+    expectimax::enumerateDraws(pool, draws, outcomes);
+    double exact = bot.chanceValue(pool, kept, draws);
+    double estimate = 0;
+    for (int s = 0; s < samples; ++s) estimate += bot.handValue(sampleRefill(pool, kept, draws, rng));
+    estimate /= samples;
+
+    out.squaredError += (estimate - exact) * (estimate - exact);
+    out.outcomes += static_cast<double>(outcomes.size());
+    ++out.nodes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) opt.games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue) opt.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--depth" && hasValue) opt.depth = std::clamp(std::atoi(argv[++i]), 1, 2);
+        else if (arg == "--width" && hasValue) opt.width = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--max-outcomes" && hasValue) opt.maxOutcomes = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--samples" && hasValue) opt.samples = std::max(0, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: qwirkle_expect [--games N] [--seed S] [--depth D] [--width W] "
+                         "[--max-outcomes M] [--samples K]\n";
+            return 1;
+        }
+    }
+
+    ExpectimaxBot bot;
+    HeuristicBot heuristic;
+    ExpectimaxLimits limits;
+    limits.depth = opt.depth;
+    limits.width = opt.width;
+    limits.maxOutcomes = opt.maxOutcomes;
+    Rng sampler(opt.seed);
+    Comparison comparison;
+
+    double marginSum = 0, botMs = 0;
+    int botMoves = 0;
+    for (int g = 0; g < opt.games; ++g) {
+        for (int botSeat = 0; botSeat < 2; ++botSeat) {
+            GameState state(2, opt.seed + g);
+            state.board.trackLines();
+            state.deal();
+            int passes = 0;
+            while (!state.isGameOver() && passes < state.playerCount()) {
+                Move m;
+                if (state.currentPlayer == botSeat) {
+                    auto t0 = std::chrono::steady_clock::now();
+                    m = bot.choose(state, limits);
+                    botMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+                    ++botMoves;
+                    if (opt.samples > 0 && !m.empty()) compare(bot, state, m, opt.samples, sampler, comparison);
+                } else {
+                    m = heuristic.choose(state);
+                }
+                passes = m.empty() ? passes + 1 : 0;
+                state.applyMove(m);
+            }
+            marginSum += state.scores[botSeat] - state.scores[1 - botSeat];
+        }
+    }
+
+    std::printf("%d games, depth %d: expectimax margin vs heuristic %+.2f per game, %.2f ms per move\n",
+                2 * opt.games, opt.depth, marginSum / (2 * opt.games), botMs / std::max(1, botMoves));
+    std::uint64_t lookups = bot.chanceNodes() + bot.cacheHits();
+    std::printf("chance nodes: %llu expanded, %llu cache hits (%.1f%%), %.1f refills per expanded node\n",
+                static_cast<unsigned long long>(bot.chanceNodes()), static_cast<unsigned long long>(bot.cacheHits()),
+                100.0 * bot.cacheHits() / std::max<std::uint64_t>(1, lookups),
+                static_cast<double>(bot.outcomesVisited()) / std::max<std::uint64_t>(1, bot.chanceNodes()));
+    if (opt.depth >= 2) std::printf("depth 2 used on %llu of %d moves\n", static_cast<unsigned long long>(bot.deepDecisions()), botMoves);
+    if (comparison.nodes > 0) {
+        std::printf("exact nodes: %.1f distinct refills each; Monte Carlo with %d samples: RMS error %.4f\n",
+                    comparison.outcomes / comparison.nodes, opt.samples,
+                    std::sqrt(comparison.squaredError / comparison.nodes));
+    }
+    return 0;
+}
@@ -0,0 +1,277 @@
+// Replay-to-video export. Renders one game from an archive offscreen at a
+// fixed frame rate, with each move's tiles dropping in one after another and
+// the camera easing out as the board grows. Frames go out as a raw RGBA
+// stream (for ffmpeg) or as a PNG sequence. Rendering and output are
+// pipelined: the renderer hands each frame to a writer thread (raw) or to the
+// thread pool (PNG) and moves on, with at most --queue frames in between.
+// Needs a GL context: run it under xvfb-run on a headless machine.
+//
+// usage: qwirkle_export --archive FILE [--game N] (--raw FILE|- | --frames DIR)
+//                       [--fps F] [--move-seconds S] [--hold S] [--size WxH]
+//                       [--threads T] [--queue Q]
+//
+//   qwirkle_export --archive games.txt --raw - --size 1280x720 |
+//       ffmpeg -f rawvideo -pix_fmt rgba -s 1280x720 -r 30 -i - replay.mp4
+#include "BoardRenderer.h"
+#include "GameRecord.h"
+#include "ImageWriter.h"
+#include "TextureAtlas.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace {
+
+struct Options {
+    std::string archive;
+    size_t game = 0;
+    std::string raw;    // raw RGBA output, "-" for stdout
+    std::string frames; // PNG sequence directory
+    int fps = 30;
+    double moveSeconds = 0.8;
+    double holdSeconds = 1.0; // still frames before the first move and after the last
+    unsigned width = 1280, height = 720;
+    int threads = 0; // PNG encoder threads, 0 = hardware concurrency
+    int queue = 0;   // frames between renderer and output, 0 = four per thread
+};
+
+// Placement animation timing, in seconds
+const double STAGGER = 0.06; // between the tiles of one move
+const double DROP = 0.3;     // one tile growing in
+const double PAN = 0.5;      // camera easing to the new framing
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Overshoots a little before settling at 1
+float easeOutBack(double u) {
+    const double c1 = 1.70158, c3 = c1 + 1;
+    return static_cast<float>(1 + c3 * (u - 1) * (u - 1) * (u - 1) + c1 * (u - 1) * (u - 1));
+}
+
+float easeInOut(double u) {
+    return static_cast<float>(u < 0.5 ? 2 * u * u : 1 - (-2 * u + 2) * (-2 * u + 2) / 2);
+}
+
+sf::FloatRect lerp(const sf::FloatRect& a, const sf::FloatRect& b, float t) {
+    return sf::FloatRect(a.left + (b.left - a.left) * t, a.top + (b.top - a.top) * t,
+                         a.width + (b.width - a.width) * t, a.height + (b.height - a.height) * t);
+}
+
+// Writes frames in order as raw RGBA on its own thread; write() blocks while
+// `limit` frames are waiting
+class RawStream {
+public:
+    RawStream(std::FILE* file, int limit) : file(file), limit(limit), thread(&RawStream::run, this) {}
+    ~RawStream() { finish(); }
+
+    void write(sf::Image frame) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&] { return static_cast<int>(queue.size()) < limit; });
+            queue.push_back(std::move(frame));
+            peak = std::max(peak, static_cast<int>(queue.size()));
+        }
+        changed.notify_all();
+    }
+
+    // Idempotent; the destructor's call is a no-op after an explicit one
+    void finish() {
+        if (!thread.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closing = true;
+        }
+        changed.notify_all();
+        thread.join();
+        if (std::fflush(file) != 0) error = true;
+    }
+
+    bool failed() const { return error; }
+    int peakQueued() const { return peak; }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            changed.wait(lock, [&] { return closing || !queue.empty(); });
+            if (queue.empty()) return;
+            sf::Image frame = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            changed.notify_all();
+            sf::Vector2u size = frame.getSize();
+            size_t bytes = static_cast<size_t>(size.x) * size.y * 4;
+            if (std::fwrite(frame.getPixelsPtr(), 1, bytes, file) != bytes) error = true;
+            lock.lock();
+        }
+    }
+
+    std::FILE* file;
+    int limit;
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<sf::Image> queue;
+    bool closing = false;
+    bool error = false;
+    int peak = 0;
+    std::thread thread;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--archive" && hasValue) opt.archive = argv[++i];
+        else if (arg == "--game" && hasValue) opt.game = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--raw" && hasValue) opt.raw = argv[++i];
+        else if (arg == "--frames" && hasValue) opt.frames = argv[++i];
+        else if (arg == "--fps" && hasValue) opt.fps = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--move-seconds" && hasValue) opt.moveSeconds = std::max(0.0, std::atof(argv[++i]));
+        else if (arg == "--hold" && hasValue) opt.holdSeconds = std::max(0.0, std::atof(argv[++i]));
+        else if (arg == "--size" && hasValue && std::sscanf(argv[++i], "%ux%u", &opt.width, &opt.height) == 2
+                 && opt.width >= 16 && opt.height >= 16) {}
+        else if (arg == "--threads" && hasValue) opt.threads = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--queue" && hasValue) opt.queue = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: qwirkle_export --archive FILE [--game N] (--raw FILE|- | --frames DIR)\n"
+                         "                      [--fps F] [--move-seconds S] [--hold S] [--size WxH]\n"
+                         "                      [--threads T] [--queue Q]\n";
+            return 1;
+        }
+    }
+    if (opt.archive.empty() || opt.raw.empty() == opt.frames.empty()) {
+        std::cerr << "Error: give --archive and exactly one of --raw and --frames\n";
+        return 1;
+    }
+
+    // Stream up to the wanted record
+    std::ifstream in(opt.archive);
+    if (!in) {
+        std::cerr << "Error: could not read archive '" << opt.archive << "'\n";
+        return 1;
+    }
+    GameRecord record;
+    for (size_t index = 0;; ++index) {
+        if (!(in >> std::ws) || in.peek() == EOF) {
+            std::cerr << "Error: archive '" << opt.archive << "' has no game " << opt.game << "\n";
+            return 1;
+        }
+        if (!record.read(in)) {
+            std::cerr << "Error: malformed record " << index << " in '" << opt.archive << "'\n";
+            return 1;
+        }
+        if (index == opt.game) break;
+    }
+
+    TextureAtlas atlas;
+    if (!atlas.load("assets/tiles") && !atlas.load("../assets/tiles")) return 1;
+    BoardRenderer renderer(atlas);
+    if (!renderer.create(opt.width, opt.height)) {
+        std::cerr << "Error: could not create a " << opt.width << "x" << opt.height << " render texture\n";
+        return 1;
+    }
+
+    ThreadPool::configureShared(opt.threads);
+    ThreadPool& pool = ThreadPool::shared();
+    int limit = opt.queue > 0 ? opt.queue : 4 * pool.size();
+
+    // Output stage: ordered raw stream, or PNGs encoded in parallel
+    std::FILE* rawFile = nullptr;
+    std::unique_ptr<RawStream> raw;
+    std::unique_ptr<ImageWriter> pngs;
+    if (!opt.raw.empty()) {
+        rawFile = opt.raw == "-" ? stdout : std::fopen(opt.raw.c_str(), "wb");
+        if (!rawFile) {
+            std::cerr << "Error: could not write '" << opt.raw << "'\n";
+            return 1;
+        }
+        raw = std::make_unique<RawStream>(rawFile, limit);
+    } else {
+        std::error_code ec;
+        std::filesystem::create_directories(opt.frames, ec);
+        if (ec) {
+            std::cerr << "Error: could not create '" << opt.frames << "'\n";
+            return 1;
+        }
+        pngs = std::make_unique<ImageWriter>(pool, limit);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    double renderSecs = 0;
+    long frames = 0;
+    auto emit = [&](const sf::FloatRect& area) {
+        auto r0 = std::chrono::steady_clock::now();
+        sf::Image image = renderer.render(area);
+        renderSecs += secondsSince(r0);
+        if (raw) {
+            raw->write(std::move(image));
+        } else {
+            char name[32];
+            std::snprintf(name, sizeof(name), "frame_%06ld.png", frames);
+            pngs->write(std::move(image), (std::filesystem::path(opt.frames) / name).string());
+        }
+        ++frames;
+    };
+
+    int holdFrames = static_cast<int>(opt.holdSeconds * opt.fps + 0.5);
+    int moveFrames = std::max(1, static_cast<int>(opt.moveSeconds * opt.fps + 0.5));
+    for (int f = 0; f < holdFrames; ++f) emit(renderer.fitArea());
+    for (const Move& move : record.moves) {
+        sf::FloatRect from = renderer.fitArea();
+        int base = renderer.tileCount();
+        for (const Placement& p : move) renderer.addTile(p.pos.first, p.pos.second, p.tile);
+        sf::FloatRect to = renderer.fitArea();
+        for (int f = 0; f < moveFrames; ++f) {
+            // The last frame of a move always shows it settled
+            bool last = f + 1 == moveFrames;
+            double t = static_cast<double>(f + 1) / opt.fps;
+            for (int k = 0; k < static_cast<int>(move.size()); ++k) {
+                double u = last ? 1.0 : std::clamp((t - k * STAGGER) / DROP, 0.0, 1.0);
+                renderer.animateTile(base + k, std::max(0.0f, easeOutBack(u)),
+                                     static_cast<sf::Uint8>(255 * std::min(1.0, 2 * u)));
+            }
+            emit(lerp(from, to, last ? 1.0f : easeInOut(std::min(1.0, t / PAN))));
+        }
+    }
+    for (int f = 0; f < holdFrames; ++f) emit(renderer.fitArea());
+
+    bool failed = false;
+    int peak = 0;
+    if (raw) {
+        raw->finish();
+        failed = raw->failed();
+        peak = raw->peakQueued();
+        raw.reset(); // done with the FILE before it is closed
+        if (rawFile != stdout && std::fclose(rawFile) != 0) failed = true;
+    } else {
+        pngs->finish();
+        failed = pngs->failures() > 0;
+        peak = pngs->peakQueued();
+    }
+    double secs = secondsSince(t0);
+    double videoSecs = static_cast<double>(frames) / opt.fps;
+    std::fprintf(stderr, "%ld frames (%.1fs of video at %d fps) in %.2fs: %.1fx real time, render %.0f%%, "
+                 "at most %d frames queued\n", frames, videoSecs, opt.fps, secs, videoSecs / std::max(secs, 1e-9),
+                 100.0 * renderSecs / std::max(secs, 1e-9), peak);
+    if (failed) {
+        std::cerr << "Error: some frames could not be written\n";
+        return 1;
+    }
+    return 0;
+}
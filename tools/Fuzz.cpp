@@ -0,0 +1,486 @@
+// Rules fuzzer: plays random games, mixing legal moves with deliberately
+// broken ones, and after every move cross-checks the engine's incremental
+// state (Zobrist hash, frontier, segments, open lines), validator, scorer
+// and move generator against brute-force recomputation from the raw board
+// tiles. Generator checks also compare the batch scoring kernels with the
+// per-move scorer.
+//
+// Games run in parallel on the shared thread pool. Game i is played from
+// seed S + i, so `--seed <its seed> --games 1` replays it alone. When games
+// fail, the first one in seed order is reported: it is shrunk by dropping
+// moves and placements while the failure still reproduces, then written out
+// as a game record.
+//
+// usage: qwirkle_fuzz [--games N] [--seed S] [--players P] [--probes K]
+//                     [--ref-every M] [--out FILE] [--threads T]
+#include "GameRecord.h"
+#include "MoveGen.h"
+#include "Rules.h"
+#include "ScoreBatch.h"
+#include "ThreadPool.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    long long games = 1000;
+    std::uint32_t seed = 1;
+    int players = 2;
+    int probes = 4;     // random (mostly illegal) candidate moves checked per turn
+    int refEvery = 25;  // compare with the reference generator every M turns
+    std::string out = "fuzz_failure.txt";
+    int threads = 0;    // 0 = hardware concurrency
+};
+
+// ---- brute force, written against the raw tile map only ----
+
+using RawBoard = std::map<Coord, Tile>;
+
+RawBoard rawTiles(const Board& board) {
+    return RawBoard(board.getTiles().begin(), board.getTiles().end());
+}
+
+// Tiles of the maximal run through (x, y) along (dx, dy)
+std::vector<Tile> run(const RawBoard& tiles, int x, int y, int dx, int dy) {
+    while (tiles.count({x - dx, y - dy})) {
+        x -= dx;
+        y -= dy;
+    }
+    std::vector<Tile> line;
+    for (auto it = tiles.find({x, y}); it != tiles.end(); it = tiles.find({x += dx, y += dy})) {
+        line.push_back(it->second);
+    }
+    return line;
+}
+
+bool lineOk(const std::vector<Tile>& line) {
+    if (line.size() < 2) return true;
+    if (line.size() > 6) return false;
+    bool sameColor = true, sameShape = true;
+    for (size_t i = 0; i < line.size(); ++i) {
+        sameColor = sameColor && line[i].color == line[0].color;
+        sameShape = sameShape && line[i].shape == line[0].shape;
+        for (size_t j = 0; j < i; ++j) {
+            if (line[i] == line[j]) return false;
+        }
+    }
+    // distinct tiles sharing one attribute differ in the other
+    return sameColor || sameShape;
+}
+
+bool bruteValidate(const RawBoard& before, const Move& move) {
+    if (move.empty() || move.size() > 6) return false;
+    RawBoard after = before;
+    std::set<int> xs, ys;
+    for (const Placement& p : move) {
+        if (after.count(p.pos)) return false; // occupied or repeated
+        after[p.pos] = p.tile;
+        xs.insert(p.pos.first);
+        ys.insert(p.pos.second);
+    }
+    if (xs.size() > 1 && ys.size() > 1) return false;
+    // contiguous: the span between the extreme placements is fully filled
+    for (int x = *xs.begin(); x <= *xs.rbegin(); ++x) {
+        for (int y = *ys.begin(); y <= *ys.rbegin(); ++y) {
+            if (!after.count({x, y})) return false;
+        }
+    }
+    if (!before.empty()) {
+        bool touches = false;
+        for (const Placement& p : move) {
+            int x = p.pos.first, y = p.pos.second;
+            touches = touches || before.count({x + 1, y}) || before.count({x - 1, y})
+                   || before.count({x, y + 1}) || before.count({x, y - 1});
+        }
+        if (!touches) return false;
+    }
+    for (const Placement& p : move) {
+        if (!lineOk(run(after, p.pos.first, p.pos.second, 1, 0))) return false;
+        if (!lineOk(run(after, p.pos.first, p.pos.second, 0, 1))) return false;
+    }
+    return true;
+}
+
+int bruteScore(const RawBoard& before, const Move& move) {
+    RawBoard after = before;
+    for (const Placement& p : move) after[p.pos] = p.tile;
+    // Each distinct line of 2+ containing a placed tile scores its length
+    std::set<std::pair<Coord, int>> counted; // (line start, axis)
+    int score = 0;
+    for (const Placement& p : move) {
+        for (int axis = 0; axis < 2; ++axis) {
+            int dx = axis == 0 ? 1 : 0, dy = 1 - dx;
+            int x = p.pos.first, y = p.pos.second;
+            while (after.count({x - dx, y - dy})) {
+                x -= dx;
+                y -= dy;
+            }
+            std::vector<Tile> line = run(after, x, y, dx, dy);
+            if (line.size() < 2 || !counted.insert({{x, y}, axis}).second) continue;
+            score += static_cast<int>(line.size()) + (line.size() == 6 ? 6 : 0);
+        }
+    }
+    return std::max(score, 1);
+}
+
+// Lines of 4-5 with the kinds legal at either end, as Board::getOpenLines()
+std::map<LineKey, std::uint64_t> bruteOpenLines(const RawBoard& tiles) {
+    std::map<LineKey, std::uint64_t> open;
+    for (const auto& [pos, tile] : tiles) {
+        for (int axis = 0; axis < 2; ++axis) {
+            int dx = axis == 0 ? 1 : 0, dy = 1 - dx;
+            if (tiles.count({pos.first - dx, pos.second - dy})) continue; // not a run start
+            int length = static_cast<int>(run(tiles, pos.first, pos.second, dx, dy).size());
+            if (length != 4 && length != 5) continue;
+            std::uint64_t completers = 0;
+            for (Coord end : {Coord{pos.first - dx, pos.second - dy}, Coord{pos.first + length * dx, pos.second + length * dy}}) {
+                for (int k = 0; k < TILE_KINDS; ++k) {
+                    RawBoard after = tiles;
+                    after[end] = tileFromIndex(k);
+                    if (lineOk(run(after, end.first, end.second, 1, 0)) && lineOk(run(after, end.first, end.second, 0, 1))) {
+                        completers |= std::uint64_t{1} << k;
+                    }
+                }
+            }
+            if (completers) open[{pos, axis == 1}] = completers;
+        }
+    }
+    return open;
+}
+
+// ---- checks ----
+
+struct Failure {
+    std::string what;
+};
+
+bool checkState(const Board& board, Failure& f) {
+    std::uint64_t hash = 0;
+    std::set<Coord> frontier;
+    for (const auto& t : board.getTiles()) {
+        hash ^= zobrist::key(t.first.first, t.first.second, t.second);
+        int x = t.first.first, y = t.first.second;
+        for (Coord n : {Coord{x + 1, y}, Coord{x - 1, y}, Coord{x, y + 1}, Coord{x, y - 1}}) {
+            if (!board.getTiles().count(n)) frontier.insert(n);
+        }
+    }
+    if (hash != board.getHash()) {
+        f.what = "incremental hash differs from recomputation";
+        return false;
+    }
+    if (!std::equal(frontier.begin(), frontier.end(), board.getFrontier().begin(), board.getFrontier().end())) {
+        f.what = "incremental frontier differs from recomputation";
+        return false;
+    }
+    RawBoard raw = rawTiles(board);
+    for (const auto& [pos, tile] : raw) {
+        for (int axis = 0; axis < 2; ++axis) {
+            int dx = axis == 0 ? 1 : 0, dy = 1 - dx;
+            int x = pos.first, y = pos.second;
+            while (raw.count({x - dx, y - dy})) {
+                x -= dx;
+                y -= dy;
+            }
+            unsigned colors = 0, shapes = 0;
+            std::vector<Tile> line = run(raw, x, y, dx, dy);
+            for (const Tile& t : line) {
+                colors |= 1u << static_cast<int>(t.color);
+                shapes |= 1u << static_cast<int>(t.shape);
+            }
+            const Segment* seg = board.segmentAt(pos.first, pos.second, axis == 1);
+            bool sameColor = std::all_of(line.begin(), line.end(), [&](const Tile& t) { return t.color == line[0].color; });
+            bool sameShape = std::all_of(line.begin(), line.end(), [&](const Tile& t) { return t.shape == line[0].shape; });
+            if (!seg || seg->start != (axis == 0 ? x : y) || seg->length != line.size() || seg->colors != colors
+                || seg->shapes != shapes || ((seg->uniform & Segment::SAME_COLOR) != 0) != sameColor
+                || ((seg->uniform & Segment::SAME_SHAPE) != 0) != sameShape) {
+                f.what = "incremental segment at " + std::to_string(pos.first) + "," + std::to_string(pos.second)
+                       + " differs from recomputation";
+                return false;
+            }
+        }
+    }
+    std::map<LineKey, std::uint64_t> open = bruteOpenLines(raw);
+    int counts[2] = {};
+    std::uint64_t qwirkle = 0;
+    bool same = open.size() == board.getOpenLines().size();
+    for (const auto& [key, line] : board.getOpenLines()) {
+        auto it = open.find(key);
+        same = same && it != open.end() && it->second == line.completers
+            && line.length == run(rawTiles(board), key.first.first, key.first.second, key.second ? 0 : 1, key.second ? 1 : 0).size();
+    }
+    for (const auto& [key, completers] : open) {
+        int length = static_cast<int>(run(rawTiles(board), key.first.first, key.first.second, key.second ? 0 : 1, key.second ? 1 : 0).size());
+        ++counts[length - 4];
+        if (length == 5) qwirkle |= completers;
+    }
+    if (!same || counts[0] != board.openLineCount(4) || counts[1] != board.openLineCount(5)
+        || qwirkle != board.getQwirkleCompleters()) {
+        f.what = "incremental open lines differ from recomputation";
+        return false;
+    }
+    return true;
+}
+
+bool checkMove(const Board& board, const Move& move, Failure& f) {
+    RawBoard raw = rawTiles(board);
+    bool legal = rules::validateMove(board, move);
+    if (legal != bruteValidate(raw, move)) {
+        f.what = std::string("validator says ") + (legal ? "legal" : "illegal") + ", brute force disagrees: " + formatMove(move);
+        return false;
+    }
+    if (legal && rules::scoreMove(board, move) != bruteScore(raw, move)) {
+        f.what = "score " + std::to_string(rules::scoreMove(board, move)) + " != brute force "
+               + std::to_string(bruteScore(raw, move)) + ": " + formatMove(move);
+        return false;
+    }
+    return true;
+}
+
+bool checkGenerator(const GameState& state, Failure& f) {
+    MoveList fast, reference;
+    movegen::generateMoves(state.board, state.hand(), fast);
+    movegen::generateMovesReference(state.board, state.hand(), reference);
+    std::set<std::vector<std::tuple<int, int, int>>> a;
+    for (const Move& m : fast) a.insert(movegen::canonicalKey(m));
+    std::set<std::vector<std::tuple<int, int, int>>> b;
+    for (const Move& m : reference) b.insert(movegen::canonicalKey(m));
+    if (a != b || a.size() != fast.size()) {
+        f.what = "move generator: " + std::to_string(fast.size()) + " moves (" + std::to_string(a.size())
+               + " distinct), reference " + std::to_string(reference.size());
+        return false;
+    }
+
+    // Batch scoring, from the generator's line lengths and from a board walk
+    MoveList batched;
+    ScoreBatch fromGen, fromBoard;
+    movegen::generateMoves(state.board, state.hand(), batched, fromGen);
+    for (const Move& m : batched) fromBoard.add(state.board, m);
+    std::vector<std::uint8_t> scores[3], qwirkles[3];
+    for (int i = 0; i < 3; ++i) {
+        scores[i].resize(batched.size());
+        qwirkles[i].resize(batched.size());
+    }
+    rules::scoreBatch(fromGen, scores[0].data(), qwirkles[0].data());
+    rules::scoreBatchScalar(fromGen, scores[1].data(), qwirkles[1].data());
+    rules::scoreBatch(fromBoard, scores[2].data(), qwirkles[2].data());
+    for (size_t i = 0; i < batched.size(); ++i) {
+        int expected = rules::scoreMove(state.board, batched[i]);
+        for (int k = 0; k < 3; ++k) {
+            if (scores[k][i] != expected || qwirkles[k][i] != qwirkles[0][i]) {
+                f.what = "batch score " + std::to_string(scores[k][i]) + " (variant " + std::to_string(k)
+                       + ") != " + std::to_string(expected) + ": " + formatMove(batched[i]);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Replays a record checking every step; the last move may be an illegal
+// probe, which is checked but not applied. Earlier moves only need to be
+// board-legal (shrinking changes the draws, so hands are not enforced).
+bool reproduces(const GameRecord& record, bool checkGen, Failure& f) {
+    GameState state(record.players, record.seed);
+    state.board.trackLines();
+    state.deal();
+    for (size_t i = 0; i < record.moves.size(); ++i) {
+        const Move& m = record.moves[i];
+        bool last = i + 1 == record.moves.size();
+        if (!m.empty()) {
+            if (!checkMove(state.board, m, f)) return true;
+            if (!last && !bruteValidate(rawTiles(state.board), m)) return false; // not a valid prefix
+            if (last && !rules::validateMove(state.board, m)) break;
+        }
+        state.applyMove(m);
+        if (!checkState(state.board, f)) return true;
+    }
+    return checkGen && !checkGenerator(state, f);
+}
+
+GameRecord shrink(GameRecord record, bool checkGen) {
+    Failure f;
+    bool progress = true;
+    while (progress) {
+        progress = false;
+        // Drop whole moves, then single placements
+        for (size_t i = 0; i < record.moves.size(); ++i) {
+            GameRecord candidate = record;
+            candidate.moves.erase(candidate.moves.begin() + i);
+            if (!candidate.moves.empty() && reproduces(candidate, checkGen, f)) {
+                record = candidate;
+                progress = true;
+                --i;
+            }
+        }
+        for (size_t i = 0; i < record.moves.size(); ++i) {
+            for (int j = 0; j < record.moves[i].size() && record.moves[i].size() > 1; ++j) {
+                GameRecord candidate = record;
+                Move& m = candidate.moves[i];
+                std::copy(m.placements.begin() + j + 1, m.placements.begin() + m.count, m.placements.begin() + j);
+                --m.count;
+                if (reproduces(candidate, checkGen, f)) {
+                    record = candidate;
+                    progress = true;
+                    --j;
+                }
+            }
+        }
+    }
+    return record;
+}
+
+// A random candidate near the frontier: 1-3 hand tiles on a random line
+Move randomProbe(const GameState& state, std::mt19937& rng) {
+    Move m;
+    std::vector<Tile> tiles;
+    for (const auto& slot : state.hand()) {
+        if (slot) tiles.push_back(*slot);
+    }
+    if (tiles.empty()) return m;
+    Coord start{0, 0};
+    const CoordSet& frontier = state.board.getFrontier();
+    if (!frontier.empty()) {
+        auto it = frontier.begin();
+        std::advance(it, rng() % frontier.size());
+        start = *it;
+    }
+    int dx = 0, dy = 0;
+    (rng() & 1 ? dx : dy) = (rng() & 1) ? 1 : -1;
+    int count = 1 + static_cast<int>(rng() % 3);
+    int step = 1 + static_cast<int>(rng() % 2); // sometimes leave gaps
+    for (int i = 0; i < count; ++i) {
+        Coord c{start.first + i * step * dx, start.second + i * step * dy};
+        m.add({c, tiles[rng() % tiles.size()]});
+    }
+    return m;
+}
+
+// One game from `seed`: random legal moves with probes and checks between
+// them. Stops at the first mismatch, with the moves so far in `record`.
+struct GameResult {
+    GameRecord record;
+    Failure failure;
+    bool failed = false;
+    bool genFailure = false;
+    long long moves = 0, probes = 0;
+};
+
+GameResult playGame(const Options& opt, std::uint32_t seed) {
+    GameResult result;
+    GameRecord& record = result.record;
+    Failure& f = result.failure;
+    record.seed = seed;
+    record.players = opt.players;
+    GameState state(record.players, record.seed);
+    state.board.trackLines();
+    state.deal();
+    std::mt19937 rng(seed);
+
+    bool& failed = result.failed;
+    int passes = 0;
+    for (int turn = 0; !failed && !state.isGameOver() && passes < state.playerCount(); ++turn) {
+        for (int p = 0; p < opt.probes && !failed; ++p, ++result.probes) {
+            Move probe = randomProbe(state, rng);
+            if (!probe.empty() && !checkMove(state.board, probe, f)) {
+                record.moves.push_back(probe);
+                failed = true;
+            }
+        }
+        if (failed) break;
+        if (opt.refEvery > 0 && turn % opt.refEvery == 0 && !checkGenerator(state, f)) {
+            failed = result.genFailure = true;
+            break;
+        }
+
+        MoveList legal;
+        movegen::generateMoves(state.board, state.hand(), legal);
+        Move m = legal.empty() ? Move{} : legal[rng() % legal.size()];
+        passes = m.empty() ? passes + 1 : 0;
+        record.moves.push_back(m);
+        if (!m.empty() && !checkMove(state.board, m, f)) {
+            failed = true;
+            break;
+        }
+        state.applyMove(m);
+        ++result.moves;
+        failed = !checkState(state.board, f);
+    }
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) opt.games = std::atoll(argv[++i]);
+        else if (arg == "--seed" && hasValue) opt.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--players" && hasValue) opt.players = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--probes" && hasValue) opt.probes = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--ref-every" && hasValue) opt.refEvery = std::atoi(argv[++i]);
+        else if (arg == "--out" && hasValue) opt.out = argv[++i];
+        else if (arg == "--threads" && hasValue) opt.threads = std::max(0, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: qwirkle_fuzz [--games N] [--seed S] [--players P] [--probes K] "
+                         "[--ref-every M] [--out FILE] [--threads T]\n";
+            return 1;
+        }
+    }
+
+    ThreadPool::configureShared(opt.threads);
+    auto t0 = std::chrono::steady_clock::now();
+    std::atomic<long long> moves{0}, probes{0};
+
+    // Games run in parallel. Once one fails, only games before it in seed
+    // order keep running, so the failure reported is the first one.
+    std::atomic<long long> firstFailed{opt.games};
+    std::mutex failureMutex;
+    GameResult failure;
+    ThreadPool::shared().parallelFor(0, static_cast<std::size_t>(opt.games), [&](std::size_t i) {
+        long long g = static_cast<long long>(i);
+        if (g > firstFailed.load(std::memory_order_relaxed)) return;
+        GameResult result = playGame(opt, opt.seed + static_cast<std::uint32_t>(g));
+        moves += result.moves;
+        probes += result.probes;
+        if (!result.failed) return;
+        std::lock_guard<std::mutex> lock(failureMutex);
+        if (g < firstFailed.load(std::memory_order_relaxed)) {
+            firstFailed.store(g, std::memory_order_relaxed);
+            failure = std::move(result);
+        }
+    });
+
+    if (firstFailed.load() < opt.games) {
+        const GameRecord& record = failure.record;
+        Failure f = failure.failure;
+        std::cerr << "game " << firstFailed.load() << " (seed " << record.seed << "): " << f.what << "\n";
+        GameRecord minimal = shrink(record, failure.genFailure);
+        reproduces(minimal, failure.genFailure, f);
+        std::cerr << "shrunk " << record.moves.size() << " -> " << minimal.moves.size()
+                  << " moves: " << f.what << "\n";
+        std::ofstream out(opt.out);
+        minimal.write(out);
+        std::cerr << "wrote " << opt.out << "\n";
+        return 1;
+    }
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("%lld games, %lld moves, %lld probes checked in %.2fs (%.0f moves/s, %d threads): no mismatches\n",
+                opt.games, moves.load(), probes.load(), secs, moves.load() / secs, ThreadPool::shared().size());
+    return 0;
+}
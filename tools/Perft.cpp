@@ -0,0 +1,169 @@
+// Move-generation perft: counts legal moves and leaf positions to a fixed
+// depth from a seeded position, with bag draws fixed by the seed. Root moves
+// are split across the workers of the shared thread pool; --pin binds each
+// worker to a CPU. With --verify every node is also generated by the slow
+// reference generator and the two move sets are compared.
+//
+// usage: qwirkle_perft [--seed S] [--players P] [--plies N] [--depth D]
+//                      [--threads T] [--pin] [--verify] [--divide]
+#include "GameState.h"
+#include "MoveGen.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::uint32_t seed = 1;
+    int players = 2;
+    int plies = 8;
+    int depth = 2;
+    int threads = 0; // 0 = hardware concurrency
+    bool pin = false;
+    bool verify = false;
+    bool divide = false;
+};
+
+struct Counts {
+    unsigned long long leaves = 0;
+    unsigned long long moves = 0; // legal moves summed over interior nodes
+    unsigned long long nodes = 0; // positions visited
+    unsigned long long mismatches = 0;
+
+    Counts& operator+=(const Counts& o) {
+        leaves += o.leaves;
+        moves += o.moves;
+        nodes += o.nodes;
+        mismatches += o.mismatches;
+        return *this;
+    }
+};
+
+// Legal moves of the side to move; a pass when there are none
+MoveList legalMoves(const GameState& state) {
+    MoveList moves;
+    movegen::generateMoves(state.board, state.hand(), moves);
+    if (moves.empty()) moves.push_back(Move{});
+    return moves;
+}
+
+bool sameMoveSet(const MoveList& fast, const MoveList& reference) {
+    std::set<std::vector<std::tuple<int, int, int>>> a, b;
+    for (const Move& m : fast) {
+        if (!m.empty()) a.insert(movegen::canonicalKey(m));
+    }
+    for (const Move& m : reference) b.insert(movegen::canonicalKey(m));
+    size_t placements = std::count_if(fast.begin(), fast.end(), [](const Move& m) { return !m.empty(); });
+    return a == b && a.size() == placements; // no duplicates either
+}
+
+Counts perft(const GameState& state, int depth, bool verify) {
+    Counts c;
+    c.nodes = 1;
+    if (depth == 0 || state.isGameOver()) {
+        c.leaves = 1;
+        return c;
+    }
+    MoveList moves = legalMoves(state);
+    if (verify) {
+        MoveList reference;
+        movegen::generateMovesReference(state.board, state.hand(), reference);
+        if (!sameMoveSet(moves, reference)) ++c.mismatches;
+    }
+    c.moves = moves.size();
+    for (const Move& m : moves) {
+        GameState child = state;
+        child.applyMove(m);
+        c += perft(child, depth - 1, verify);
+    }
+    return c;
+}
+
+void describe(const Move& m) {
+    if (m.empty()) {
+        std::printf("pass");
+        return;
+    }
+    for (const Placement& p : m) std::printf("(%d,%d)#%d ", p.pos.first, p.pos.second, tileIndex(p.tile));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) opt.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--players" && hasValue) opt.players = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--plies" && hasValue) opt.plies = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--depth" && hasValue) opt.depth = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) opt.threads = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--pin") opt.pin = true;
+        else if (arg == "--verify") opt.verify = true;
+        else if (arg == "--divide") opt.divide = true;
+        else {
+            std::cerr << "usage: qwirkle_perft [--seed S] [--players P] [--plies N] [--depth D] "
+                         "[--threads T] [--pin] [--verify] [--divide]\n";
+            return 1;
+        }
+    }
+
+    // Start position: seeded deal, then random opening plies
+    GameState root(opt.players, opt.seed);
+    root.deal();
+    std::mt19937 chooser(opt.seed);
+    for (int i = 0; i < opt.plies && !root.isGameOver(); ++i) {
+        MoveList moves = legalMoves(root);
+        root.applyMove(moves[chooser() % moves.size()]);
+    }
+    std::printf("position: seed %u, %d players, %d plies, %zu tiles on board, %zu in bag\n",
+                opt.seed, opt.players, opt.plies, root.board.getTiles().size(), root.tileBag.size());
+
+    const MoveList rootMoves = legalMoves(root);
+    std::vector<Counts> perRoot(rootMoves.size());
+    Counts rootCounts;
+    rootCounts.nodes = 1;
+    rootCounts.moves = rootMoves.size();
+    if (opt.verify) {
+        MoveList reference;
+        movegen::generateMovesReference(root.board, root.hand(), reference);
+        if (!sameMoveSet(rootMoves, reference)) ++rootCounts.mismatches;
+    }
+
+    ThreadPool::configureShared(opt.threads, opt.pin);
+    ThreadPool& pool = ThreadPool::shared();
+    int threads = pool.size();
+    auto t0 = std::chrono::steady_clock::now();
+    pool.parallelFor(0, rootMoves.size(), [&](size_t i) {
+        GameState child = root;
+        child.applyMove(rootMoves[i]);
+        perRoot[i] = perft(child, opt.depth - 1, opt.verify);
+    });
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    Counts total = rootCounts;
+    for (size_t i = 0; i < perRoot.size(); ++i) {
+        total += perRoot[i];
+        if (opt.divide) {
+            describe(rootMoves[i]);
+            std::printf(": %llu\n", perRoot[i].leaves);
+        }
+    }
+
+    std::printf("depth %d: %llu leaves, %llu moves, %llu nodes in %.3fs (%.0f nodes/s, %d threads)\n",
+                opt.depth, total.leaves, total.moves, total.nodes, secs, total.nodes / secs, threads);
+    if (opt.verify) {
+        std::printf("reference check: %s (%llu mismatching nodes)\n",
+                    total.mismatches ? "FAILED" : "ok", total.mismatches);
+    }
+    return total.mismatches ? 2 : 0;
+}
@@ -0,0 +1,141 @@
+// Solitaire solving and puzzle mining.
+//
+// With --seed, deals a one-player game from the seed (which fixes the bag
+// order) and beam-searches for the highest total score, printing the moves;
+// --out writes them as a game record. With --archive, scans every recorded
+// position for "find the N-point move" puzzles: a best move worth at least
+// --min-score that beats every alternative by --gap or more.
+//
+// usage: qwirkle_puzzle --seed S [--width W] [--threads T] [--out FILE]
+//        qwirkle_puzzle --archive FILE [--min-score N] [--gap N] [--threads T]
+#include "GameRecord.h"
+#include "Solver.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    bool haveSeed = false;
+    std::uint32_t seed = 1;
+    int width = 512;
+    int threads = 0; // 0 = hardware concurrency
+    std::string out;
+    std::string archive;
+    int minScore = 18;
+    int gap = 4;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+int solve(const Options& opt) {
+    GameRecord record;
+    record.seed = opt.seed;
+    record.players = 1;
+    GameState start = record.replay(0);
+
+    solver::BeamOptions beam;
+    beam.width = opt.width;
+    beam.threads = opt.threads;
+    auto t0 = std::chrono::steady_clock::now();
+    solver::Solution solution = solver::solveSolitaire(start, beam);
+    double secs = secondsSince(t0);
+
+    for (const Move& m : solution.moves) std::printf("%s\n", formatMove(m).c_str());
+    std::printf("seed %u: %d points in %zu moves (%llu states expanded, %llu duplicates, %.2fs)\n",
+                opt.seed, solution.score, solution.moves.size(),
+                static_cast<unsigned long long>(solution.expanded),
+                static_cast<unsigned long long>(solution.duplicates), secs);
+
+    if (!opt.out.empty()) {
+        record.moves = solution.moves;
+        std::ofstream file(opt.out);
+        record.write(file);
+        if (!file) {
+            std::cerr << "Error: could not write '" << opt.out << "'\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int mine(const Options& opt) {
+    std::vector<GameRecord> games;
+    if (!readArchive(opt.archive, games)) {
+        std::cerr << "Error: could not read archive '" << opt.archive << "'\n";
+        return 1;
+    }
+
+    struct Found {
+        std::uint32_t ply;
+        solver::Puzzle puzzle;
+    };
+    std::vector<std::vector<Found>> found(games.size());
+    std::atomic<unsigned long long> positions{0};
+    ThreadPool& pool = ThreadPool::shared();
+    auto t0 = std::chrono::steady_clock::now();
+    pool.parallelFor(0, games.size(), [&](size_t g) {
+        GameState state = games[g].replay(0);
+        for (size_t ply = 0;; ++ply) {
+            solver::Puzzle puzzle;
+            if (!state.isGameOver() && solver::findPuzzle(state, opt.minScore, opt.gap, puzzle)) {
+                found[g].push_back(Found{ static_cast<std::uint32_t>(ply), puzzle });
+            }
+            if (ply == games[g].moves.size()) break;
+            state.applyMove(games[g].moves[ply]);
+        }
+        positions.fetch_add(games[g].moves.size() + 1, std::memory_order_relaxed);
+    });
+    double secs = secondsSince(t0);
+
+    size_t count = 0;
+    for (size_t g = 0; g < found.size(); ++g) {
+        for (const Found& f : found[g]) {
+            std::printf("game %zu ply %u: %d points (next best %d): %s\n", g, f.ply, f.puzzle.score,
+                        f.puzzle.runnerUp, formatMove(f.puzzle.answer).c_str());
+            ++count;
+        }
+    }
+    std::fprintf(stderr, "%zu puzzles from %llu positions in %.2fs (%.0f positions/s, %d threads)\n",
+                 count, positions.load(), secs, positions.load() / secs, pool.size());
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--seed" && hasValue) {
+            opt.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+            opt.haveSeed = true;
+        }
+        else if (arg == "--width" && hasValue) opt.width = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) opt.threads = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--out" && hasValue) opt.out = argv[++i];
+        else if (arg == "--archive" && hasValue) opt.archive = argv[++i];
+        else if (arg == "--min-score" && hasValue) opt.minScore = std::atoi(argv[++i]);
+        else if (arg == "--gap" && hasValue) opt.gap = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: qwirkle_puzzle --seed S [--width W] [--threads T] [--out FILE]\n"
+                         "       qwirkle_puzzle --archive FILE [--min-score N] [--gap N] [--threads T]\n";
+            return 1;
+        }
+    }
+    ThreadPool::configureShared(opt.threads);
+    if (opt.haveSeed == opt.archive.empty()) return opt.haveSeed ? solve(opt) : mine(opt);
+    std::cerr << "Error: give exactly one of --seed and --archive\n";
+    return 1;
+}
@@ -0,0 +1,112 @@
+// Position search over a game archive (game records separated by blank
+// lines). Builds the feature index on first use and caches it next to the
+// archive; later runs load the cache unless the archive changed. Runs the
+// query given on the command line, or reads one query per line from stdin.
+//
+// Queries are ';'-separated clauses, all of which must hold:
+//     pattern 0,0,7 1,0,9    tiles at relative cells (x,y,tileIndex), anywhere
+//     hand 7 7 12            tiles in the side to move's hand
+//     margin >= 10           score margin of the side to move (>=, >, <=, <, =)
+//
+// usage: qwirkle_query --archive FILE [--index FILE] [--threads T]
+//                      [--limit N] [--rebuild] [QUERY]
+#include "PositionIndex.h"
+#include "ThreadPool.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string archive;
+    std::string index; // defaults to <archive>.idx
+    int threads = 0;
+    size_t limit = 20;
+    bool rebuild = false;
+    std::string query;
+};
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+void runQuery(const PositionIndex& index, const std::vector<GameRecord>& games, const std::string& text, size_t limit) {
+    PositionQuery query;
+    if (!query.parse(text)) {
+        std::cerr << "Error: bad query '" << text << "'\n";
+        return;
+    }
+    auto t0 = std::chrono::steady_clock::now();
+    PositionIndex::Result result = index.query(query, games, limit);
+    double ms = secondsSince(t0) * 1000.0;
+
+    for (const PositionIndex::Hit& hit : result.hits) std::printf("game %u ply %u\n", hit.game, hit.ply);
+    if (result.exact) {
+        std::printf("%llu matches in %.2f ms\n", static_cast<unsigned long long>(result.candidates), ms);
+    } else {
+        std::printf("%zu matches shown (pattern checked by replay), %llu candidates in %.2f ms\n",
+                    result.hits.size(), static_cast<unsigned long long>(result.candidates), ms);
+    }
+    std::fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--archive" && hasValue) opt.archive = argv[++i];
+        else if (arg == "--index" && hasValue) opt.index = argv[++i];
+        else if (arg == "--threads" && hasValue) opt.threads = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--limit" && hasValue) opt.limit = static_cast<size_t>(std::max(0, std::atoi(argv[++i])));
+        else if (arg == "--rebuild") opt.rebuild = true;
+        else if (arg[0] != '-' && opt.query.empty()) opt.query = arg;
+        else {
+            std::cerr << "usage: qwirkle_query --archive FILE [--index FILE] [--threads T] "
+                         "[--limit N] [--rebuild] [QUERY]\n";
+            return 1;
+        }
+    }
+    if (opt.archive.empty()) {
+        std::cerr << "Error: --archive is required\n";
+        return 1;
+    }
+    if (opt.index.empty()) opt.index = opt.archive + ".idx";
+    ThreadPool::configureShared(opt.threads);
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<GameRecord> games;
+    if (!readArchive(opt.archive, games)) {
+        std::cerr << "Error: could not read archive '" << opt.archive << "'\n";
+        return 1;
+    }
+    std::fprintf(stderr, "read %zu games in %.2fs\n", games.size(), secondsSince(t0));
+
+    PositionIndex index;
+    t0 = std::chrono::steady_clock::now();
+    if (!opt.rebuild && index.load(opt.index, games)) {
+        std::fprintf(stderr, "loaded index '%s' in %.2fs\n", opt.index.c_str(), secondsSince(t0));
+    } else {
+        index.build(games, opt.threads);
+        std::fprintf(stderr, "indexed %llu positions in %.2fs\n",
+                     static_cast<unsigned long long>(index.positionCount()), secondsSince(t0));
+        if (!index.save(opt.index)) std::cerr << "Warning: could not write index '" << opt.index << "'\n";
+    }
+    std::fprintf(stderr, "index: %.1f MB\n", index.sizeBytes() / (1024.0 * 1024.0));
+
+    if (!opt.query.empty()) {
+        runQuery(index, games, opt.query, opt.limit);
+        return 0;
+    }
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        if (!line.empty()) runQuery(index, games, line, opt.limit);
+    }
+    return 0;
+}
@@ -0,0 +1,139 @@
+// Board images from a game archive, rendered offscreen: the final position of
+// every game, or every position with --per-turn. Records are streamed from
+// the archive and the PNG encoding runs on the shared thread pool while the
+// next boards render. At most --queue images wait for encoding, so memory
+// stays flat however large the archive is. Needs a GL context: run it under
+// xvfb-run on a headless machine.
+//
+// usage: qwirkle_render --archive FILE --out DIR [--per-turn] [--size PX]
+//                       [--first N] [--count N] [--threads T] [--queue Q]
+#include "BoardRenderer.h"
+#include "GameRecord.h"
+#include "ImageWriter.h"
+#include "TextureAtlas.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+
+struct Options {
+    std::string archive;
+    std::string out;
+    bool perTurn = false;
+    unsigned size = 256;
+    size_t first = 0;
+    size_t count = SIZE_MAX;
+    int threads = 0; // writer threads, 0 = hardware concurrency
+    int queue = 0;   // images waiting for encoding, 0 = four per thread
+};
+
+double secondsSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+std::string imagePath(const std::string& dir, size_t game, int ply) {
+    char name[64];
+    if (ply < 0) std::snprintf(name, sizeof(name), "%07zu.png", game);
+    else std::snprintf(name, sizeof(name), "%07zu_%03d.png", game, ply);
+    return (std::filesystem::path(dir) / name).string();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--archive" && hasValue) opt.archive = argv[++i];
+        else if (arg == "--out" && hasValue) opt.out = argv[++i];
+        else if (arg == "--per-turn") opt.perTurn = true;
+        else if (arg == "--size" && hasValue) opt.size = static_cast<unsigned>(std::max(16, std::atoi(argv[++i])));
+        else if (arg == "--first" && hasValue) opt.first = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--count" && hasValue) opt.count = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--threads" && hasValue) opt.threads = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--queue" && hasValue) opt.queue = std::max(1, std::atoi(argv[++i]));
+        else {
+            std::cerr << "usage: qwirkle_render --archive FILE --out DIR [--per-turn] [--size PX]\n"
+                         "                      [--first N] [--count N] [--threads T] [--queue Q]\n";
+            return 1;
+        }
+    }
+    if (opt.archive.empty() || opt.out.empty()) {
+        std::cerr << "Error: --archive and --out are required\n";
+        return 1;
+    }
+
+    std::ifstream in(opt.archive);
+    if (!in) {
+        std::cerr << "Error: could not read archive '" << opt.archive << "'\n";
+        return 1;
+    }
+    std::error_code ec;
+    std::filesystem::create_directories(opt.out, ec);
+    if (ec) {
+        std::cerr << "Error: could not create '" << opt.out << "'\n";
+        return 1;
+    }
+
+    TextureAtlas atlas;
+    if (!atlas.load("assets/tiles") && !atlas.load("../assets/tiles")) return 1;
+    BoardRenderer renderer(atlas);
+    if (!renderer.create(opt.size, opt.size)) {
+        std::cerr << "Error: could not create a " << opt.size << "px render texture\n";
+        return 1;
+    }
+
+    ThreadPool::configureShared(opt.threads);
+    ThreadPool& pool = ThreadPool::shared();
+    ImageWriter writer(pool, opt.queue > 0 ? opt.queue : 4 * pool.size());
+
+    auto t0 = std::chrono::steady_clock::now();
+    double renderSecs = 0;
+    size_t games = 0, images = 0;
+    for (size_t index = 0; games < opt.count && (in >> std::ws, in.peek() != EOF); ++index) {
+        GameRecord record;
+        if (!record.read(in)) {
+            std::cerr << "Error: malformed record " << index << " in '" << opt.archive << "'\n";
+            return 1;
+        }
+        if (index < opt.first) continue;
+        ++games;
+
+        renderer.clear();
+        for (size_t ply = 0; ply < record.moves.size(); ++ply) {
+            for (const Placement& p : record.moves[ply]) renderer.addTile(p.pos.first, p.pos.second, p.tile);
+            if (!opt.perTurn || record.moves[ply].empty()) continue;
+            auto r0 = std::chrono::steady_clock::now();
+            sf::Image image = renderer.render();
+            renderSecs += secondsSince(r0);
+            writer.write(std::move(image), imagePath(opt.out, index, static_cast<int>(ply + 1)));
+            ++images;
+        }
+        if (!opt.perTurn) {
+            auto r0 = std::chrono::steady_clock::now();
+            sf::Image image = renderer.render();
+            renderSecs += secondsSince(r0);
+            writer.write(std::move(image), imagePath(opt.out, index, -1));
+            ++images;
+        }
+    }
+    writer.finish();
+    double secs = secondsSince(t0);
+
+    std::fprintf(stderr, "%zu images of %zu games in %.2fs (%.0f images/s): render %.0f%%, "
+                 "%d writer threads, at most %d images queued\n", images, games, secs, images / secs,
+                 100.0 * renderSecs / std::max(secs, 1e-9), pool.size(), writer.peakQueued());
+    if (writer.failures() > 0) {
+        std::cerr << "Error: " << writer.failures() << " images could not be written\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+// Per-move time budget harness: plays seeded games between bots of one kind
+// (Searcher, or with --bot expectimax the ExpectimaxBot) with a fixed
+// wall-clock budget per move and reports how far each search ran past its
+// budget, as measured around the search call. Exits non-zero when
+// --max-overrun is given and any move exceeded it.
+//
+// usage: qwirkle_timing [--games N] [--seed S] [--players P] [--budget MS]
+//                       [--width W] [--max-overrun MS]
+//                       [--bot search|expectimax] [--depth D]
+#include "Expectimax.h"
+#include "GameState.h"
+#include "Search.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int games = 40;
+    std::uint32_t seed = 1;
+    int players = 2;
+    double budgetMs = 50;
+    int width = 8;
+    double maxOverrunMs = -1; // < 0 = report only
+    bool expectimax = false;
+    int depth = 2; // expectimax lookahead
+};
+
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t i = static_cast<size_t>(p / 100.0 * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--games" && hasValue) opt.games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue) opt.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--players" && hasValue) opt.players = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--budget" && hasValue) opt.budgetMs = std::max(0.1, std::atof(argv[++i]));
+        else if (arg == "--width" && hasValue) opt.width = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--max-overrun" && hasValue) opt.maxOverrunMs = std::atof(argv[++i]);
+        else if (arg == "--bot" && hasValue && (std::string(argv[i + 1]) == "search" || std::string(argv[i + 1]) == "expectimax")) {
+            opt.expectimax = std::string(argv[++i]) == "expectimax";
+        }
+        else if (arg == "--depth" && hasValue) opt.depth = std::clamp(std::atoi(argv[++i]), 1, 2);
+        else {
+            std::cerr << "usage: qwirkle_timing [--games N] [--seed S] [--players P] [--budget MS] "
+                         "[--width W] [--max-overrun MS] [--bot search|expectimax] [--depth D]\n";
+            return 1;
+        }
+    }
+
+    Searcher searcher;
+    SearchLimits limits;
+    limits.budgetMs = opt.budgetMs;
+    limits.width = opt.width;
+    ExpectimaxBot expectimaxBot;
+    ExpectimaxLimits expectimaxLimits;
+    expectimaxLimits.budgetMs = opt.budgetMs;
+    expectimaxLimits.depth = opt.depth;
+    expectimaxLimits.width = opt.width;
+
+    std::vector<double> overruns; // ms past the budget, negative when early
+    std::vector<int> depths;
+    int stoppedCount = 0;
+    for (int g = 0; g < opt.games; ++g) {
+        GameState state(opt.players, opt.seed + g);
+        if (opt.expectimax) state.board.trackLines(); // its heuristic terms read the open lines
+        state.deal();
+        int passes = 0;
+        while (!state.isGameOver() && passes < state.playerCount()) {
+            auto t0 = std::chrono::steady_clock::now();
+            SearchResult r;
+            if (opt.expectimax) {
+                std::uint64_t deepBefore = expectimaxBot.deepDecisions();
+                r.best = expectimaxBot.choose(state, expectimaxLimits);
+                r.stopped = expectimaxBot.lastStopped();
+                // Depth 2 counts only when it ran and finished
+                r.depth = !r.stopped && expectimaxBot.deepDecisions() > deepBefore ? 2 : 1;
+            } else {
+                r = searcher.search(state, limits);
+            }
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            overruns.push_back(ms - opt.budgetMs);
+            depths.push_back(r.depth);
+            if (r.stopped) ++stoppedCount;
+            passes = r.best.empty() ? passes + 1 : 0;
+            state.applyMove(r.best);
+        }
+    }
+
+    std::sort(overruns.begin(), overruns.end());
+    std::sort(depths.begin(), depths.end());
+    size_t over = std::count_if(overruns.begin(), overruns.end(), [](double o) { return o > 0; });
+    size_t overOne = std::count_if(overruns.begin(), overruns.end(), [](double o) { return o > 1.0; });
+    double meanDepth = 0;
+    for (int d : depths) meanDepth += d;
+    meanDepth /= std::max<size_t>(1, depths.size());
+
+    std::printf("%zu moves, budget %.1f ms, %d stopped by the budget\n", overruns.size(), opt.budgetMs, stoppedCount);
+    std::printf("depth: mean %.2f, min %d, median %d, max %d\n", meanDepth, depths.front(),
+                depths[depths.size() / 2], depths.back());
+    std::printf("overrun ms: p50 %.3f  p90 %.3f  p99 %.3f  p99.9 %.3f  max %.3f\n",
+                percentile(overruns, 50), percentile(overruns, 90), percentile(overruns, 99),
+                percentile(overruns, 99.9), overruns.back());
+    std::printf("over budget: %zu moves, over by > 1 ms: %zu moves\n", over, overOne);
+
+    if (opt.maxOverrunMs >= 0 && overruns.back() > opt.maxOverrunMs) {
+        std::printf("FAILED: max overrun %.3f ms exceeds %.3f ms\n", overruns.back(), opt.maxOverrunMs);
+        return 2;
+    }
+    return 0;
+}
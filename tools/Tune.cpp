@@ -0,0 +1,196 @@
+// SPSA tuning of the heuristic bot's evaluation weights by self-play.
+//
+// Each iteration perturbs every weight up or down at random (theta +/- c*delta)
+// and plays the two perturbed bots against each other on a fresh set of
+// seeds. Every seed is played twice with seats swapped, so both sides see
+// the same deals and bag orders (common random numbers), which cancels most
+// of the luck out of the score margin. The margin then steps the weights
+// along the estimated gradient. The score weight is anchored at 1 and sets
+// the scale of the others.
+//
+// The state is checkpointed after every iteration (written to a temporary
+// file and renamed into place) along with the run's settings. Iteration k's
+// perturbation and seeds depend only on --seed and k, so a resumed run
+// continues exactly as if it had never stopped.
+//
+// usage: qwirkle_tune [--iterations N] [--games G] [--threads T] [--seed S]
+//                     [--a A] [--c C] [--A A] [--checkpoint FILE] [--resume]
+#include "HeuristicBot.h"
+#include "Rng.h"
+#include "SelfPlay.h"
+#include "ThreadPool.h"
+#include "Zobrist.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int iterations = 200; // total, including any already checkpointed
+    int games = 64;       // seeds per iteration, each played from both seats
+    int threads = 0;      // 0 = hardware concurrency
+    std::uint32_t seed = 1;
+    double a = 0.002;     // step size, in units of each weight's scale
+    double c = 0.2;       // perturbation size, same units
+    double bigA = 20;     // step schedule stability constant
+    std::string checkpoint = "spsa.ckpt";
+    bool resume = false;
+};
+
+struct TuneState {
+    std::uint32_t seed = 1;
+    int iteration = 0; // next iteration to run
+    double a = 0, c = 0, bigA = 0;
+    int games = 0;
+    EvalWeights theta = defaultWeights();
+};
+
+// Perturbation and step sizes are relative to these
+double termScale(int term) {
+    return std::max(0.25, std::fabs(defaultWeights()[term]));
+}
+
+// qwirkle-spsa 1
+// seed S iteration K
+// a A c C bigA B games G
+// weight <name> <value>   one line per term
+bool saveCheckpoint(const std::string& path, const TuneState& s) {
+    std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp);
+        out.precision(17);
+        out << "qwirkle-spsa 1\n";
+        out << "seed " << s.seed << " iteration " << s.iteration << "\n";
+        out << "a " << s.a << " c " << s.c << " bigA " << s.bigA << " games " << s.games << "\n";
+        for (int i = 0; i < TERM_COUNT; ++i) out << "weight " << termName(i) << ' ' << s.theta[i] << "\n";
+        if (!out.flush()) return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmp, path, ec);
+    return !ec;
+}
+
+bool loadCheckpoint(const std::string& path, TuneState& s) {
+    std::ifstream in(path);
+    std::string magic, word, name;
+    int version = 0;
+    if (!(in >> magic >> version) || magic != "qwirkle-spsa" || version != 1) return false;
+    if (!(in >> word >> s.seed) || word != "seed") return false;
+    if (!(in >> word >> s.iteration) || word != "iteration") return false;
+    if (!(in >> word >> s.a) || word != "a") return false;
+    if (!(in >> word >> s.c) || word != "c") return false;
+    if (!(in >> word >> s.bigA) || word != "bigA") return false;
+    if (!(in >> word >> s.games) || word != "games" || s.games < 1) return false;
+    for (int i = 0; i < TERM_COUNT; ++i) {
+        if (!(in >> word >> name >> s.theta[i]) || word != "weight" || name != termName(i)) return false;
+    }
+    return true;
+}
+
+std::uint32_t gameSeed(std::uint32_t base, int iteration, int game) {
+    std::uint64_t h = zobrist::mix((static_cast<std::uint64_t>(base) << 32) ^ static_cast<std::uint32_t>(iteration));
+    return static_cast<std::uint32_t>(zobrist::mix(h + static_cast<std::uint64_t>(game)));
+}
+
+void printWeights(const EvalWeights& w) {
+    for (int i = 0; i < TERM_COUNT; ++i) std::printf(" %s=%.4f", termName(i), w[i]);
+    std::printf("\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--iterations" && hasValue) opt.iterations = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--games" && hasValue) opt.games = std::max(1, std::atoi(argv[++i]));
+        else if (arg == "--threads" && hasValue) opt.threads = std::max(0, std::atoi(argv[++i]));
+        else if (arg == "--seed" && hasValue) opt.seed = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--a" && hasValue) opt.a = std::atof(argv[++i]);
+        else if (arg == "--c" && hasValue) opt.c = std::atof(argv[++i]);
+        else if (arg == "--A" && hasValue) opt.bigA = std::max(0.0, std::atof(argv[++i]));
+        else if (arg == "--checkpoint" && hasValue) opt.checkpoint = argv[++i];
+        else if (arg == "--resume") opt.resume = true;
+        else {
+            std::cerr << "usage: qwirkle_tune [--iterations N] [--games G] [--threads T] [--seed S] "
+                         "[--a A] [--c C] [--A A] [--checkpoint FILE] [--resume]\n";
+            return 1;
+        }
+    }
+    ThreadPool::configureShared(opt.threads);
+
+    TuneState s;
+    if (opt.resume) {
+        if (!loadCheckpoint(opt.checkpoint, s)) {
+            std::cerr << "Error: could not resume from '" << opt.checkpoint << "'\n";
+            return 1;
+        }
+        std::printf("resumed at iteration %d:", s.iteration);
+        printWeights(s.theta);
+    } else {
+        s.seed = opt.seed;
+        s.a = opt.a;
+        s.c = opt.c;
+        s.bigA = opt.bigA;
+        s.games = opt.games;
+    }
+
+    // Standard SPSA gain schedules
+    constexpr double ALPHA = 0.602, GAMMA = 0.101;
+    for (; s.iteration < opt.iterations; ++s.iteration) {
+        int k = s.iteration;
+        double ak = s.a / std::pow(k + 1 + s.bigA, ALPHA);
+        double ck = s.c / std::pow(k + 1, GAMMA);
+
+        Rng rng(static_cast<std::uint32_t>(zobrist::mix(s.seed ^ (static_cast<std::uint64_t>(k) << 20))));
+        std::array<double, TERM_COUNT> delta{};
+        EvalWeights plus = s.theta, minus = s.theta;
+        for (int i = 1; i < TERM_COUNT; ++i) { // TermScore stays anchored
+            delta[i] = (rng() & 1) ? 1.0 : -1.0;
+            plus[i] += ck * termScale(i) * delta[i];
+            minus[i] -= ck * termScale(i) * delta[i];
+        }
+
+        std::vector<selfplay::Pairing> pairings;
+        for (int g = 0; g < s.games; ++g) {
+            std::uint32_t seed = gameSeed(s.seed, k, g);
+            pairings.push_back({ seed, plus, minus });
+            pairings.push_back({ seed, minus, plus });
+        }
+        auto t0 = std::chrono::steady_clock::now();
+        std::vector<int> margins = selfplay::playAll(pairings, opt.threads);
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        // Mean margin of plus over minus per deal
+        double r = 0;
+        for (size_t i = 0; i < margins.size(); i += 2) r += margins[i] - margins[i + 1];
+        r /= 2.0 * s.games;
+
+        for (int i = 1; i < TERM_COUNT; ++i) {
+            double gradient = r / (2.0 * ck * delta[i]); // in scaled units
+            s.theta[i] += ak * gradient * termScale(i);
+        }
+
+        std::printf("iter %d: margin %+.2f, %.0f games/s:", k, r, margins.size() / secs);
+        printWeights(s.theta);
+        std::fflush(stdout);
+
+        TuneState next = s;
+        ++next.iteration;
+        if (!saveCheckpoint(opt.checkpoint, next)) {
+            std::cerr << "Error: could not write checkpoint '" << opt.checkpoint << "'\n";
+            return 1;
+        }
+    }
+    return 0;
+}